@@ -0,0 +1,214 @@
+#include "BenchmarkAssets.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "Config.h"
+#include "Logger.h"
+
+namespace
+{
+	void WriteU16(std::ofstream& file, uint16_t value)
+	{
+		file.put(static_cast<char>(value & 0xFF));
+		file.put(static_cast<char>((value >> 8) & 0xFF));
+	}
+
+	void WriteU32(std::ofstream& file, uint32_t value)
+	{
+		WriteU16(file, static_cast<uint16_t>(value & 0xFFFF));
+		WriteU16(file, static_cast<uint16_t>(value >> 16));
+	}
+
+	/**
+	 * @brief Writes a 24 bit BMP, pixels are RGB from the top row down.
+	 */
+	bool WriteBMP(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb)
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		int rowSize = (width * 3 + 3) & ~3;
+		uint32_t imageSize = static_cast<uint32_t>(rowSize * height);
+
+		// file header
+		file.put('B');
+		file.put('M');
+		WriteU32(file, 54 + imageSize);
+		WriteU32(file, 0);
+		WriteU32(file, 54);
+
+		// info header
+		WriteU32(file, 40);
+		WriteU32(file, static_cast<uint32_t>(width));
+		WriteU32(file, static_cast<uint32_t>(height));
+		WriteU16(file, 1);
+		WriteU16(file, 24);
+		WriteU32(file, 0);
+		WriteU32(file, imageSize);
+		WriteU32(file, 2835);
+		WriteU32(file, 2835);
+		WriteU32(file, 0);
+		WriteU32(file, 0);
+
+		// rows are stored bottom up in BGR order
+		std::vector<char> row(rowSize, 0);
+		for (int y = height - 1; y >= 0; y--)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const uint8_t* pixel = &rgb[(y * width + x) * 3];
+				row[x * 3 + 0] = static_cast<char>(pixel[2]);
+				row[x * 3 + 1] = static_cast<char>(pixel[1]);
+				row[x * 3 + 2] = static_cast<char>(pixel[0]);
+			}
+			file.write(row.data(), rowSize);
+		}
+		return file.good();
+	}
+
+	/**
+	 * @brief Writes a 16 bit mono WAV.
+	 */
+	bool WriteWAV(const std::string& path, int sampleRate, const std::vector<int16_t>& samples)
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		uint32_t dataSize = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+		file.write("RIFF", 4);
+		WriteU32(file, 36 + dataSize);
+		file.write("WAVE", 4);
+		file.write("fmt ", 4);
+		WriteU32(file, 16);
+		WriteU16(file, 1);
+		WriteU16(file, 1);
+		WriteU32(file, static_cast<uint32_t>(sampleRate));
+		WriteU32(file, static_cast<uint32_t>(sampleRate * sizeof(int16_t)));
+		WriteU16(file, sizeof(int16_t));
+		WriteU16(file, 16);
+		file.write("data", 4);
+		WriteU32(file, dataSize);
+		for (int16_t sample : samples)
+		{
+			WriteU16(file, static_cast<uint16_t>(sample));
+		}
+		return file.good();
+	}
+
+	/**
+	 * @brief Fills an image with a checkerboard tinted by a seed.
+	 */
+	std::vector<uint8_t> MakePattern(int width, int height, int cellSize, int seed)
+	{
+		std::vector<uint8_t> rgb(width * height * 3);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				bool dark = ((x / cellSize) + (y / cellSize)) % 2 == 0;
+				uint8_t* pixel = &rgb[(y * width + x) * 3];
+				pixel[0] = static_cast<uint8_t>(dark ? 40 + seed * 13 % 200 : 230);
+				pixel[1] = static_cast<uint8_t>(dark ? 40 + seed * 29 % 200 : 230);
+				pixel[2] = static_cast<uint8_t>(dark ? 40 + seed * 47 % 200 : 230);
+			}
+		}
+		return rgb;
+	}
+
+	bool GenerateFile(const std::string& path, bool (*generate)(const std::string&))
+	{
+		if (std::filesystem::exists(path))
+		{
+			return true;
+		}
+		if (!generate(path))
+		{
+			LogError("Failed to generate benchmark asset %s", path.c_str());
+			return false;
+		}
+		return true;
+	}
+}
+
+bool BenchmarkAssets::Generate()
+{
+	std::error_code error;
+	std::filesystem::create_directories(ResourcesPath::TEXTURE, error);
+	std::filesystem::create_directories(ResourcesPath::SOUND, error);
+
+	bool ok = true;
+	ok &= GenerateFile(ResourcesPath::TEXTURE + SPRITE_TEXTURE, [](const std::string& path)
+		{
+			return WriteBMP(path, 64, 64, MakePattern(64, 64, 8, 1));
+		});
+
+	ok &= GenerateFile(ResourcesPath::TEXTURE + SHEET_TEXTURE, [](const std::string& path)
+		{
+			// one colour per frame so the frames are easy to tell apart
+			int frameSize = 64;
+			std::vector<uint8_t> rgb;
+			for (int y = 0; y < frameSize; y++)
+			{
+				for (int frame = 0; frame < SHEET_FRAME_COUNT; frame++)
+				{
+					auto pattern = MakePattern(frameSize, 1, 8, frame + 2);
+					rgb.insert(rgb.end(), pattern.begin(), pattern.end());
+				}
+			}
+			return WriteBMP(path, frameSize * SHEET_FRAME_COUNT, frameSize, rgb);
+		});
+
+	ok &= GenerateFile(ResourcesPath::SOUND + BEEP_SOUND, [](const std::string& path)
+		{
+			// 100 ms of a 880 Hz tone with a linear fade out
+			const int sampleRate = 44100;
+			std::vector<int16_t> samples(sampleRate / 10);
+			for (size_t i = 0; i < samples.size(); i++)
+			{
+				float t = static_cast<float>(i) / sampleRate;
+				float fade = 1.f - static_cast<float>(i) / samples.size();
+				samples[i] = static_cast<int16_t>(std::sin(t * 880.f * 6.2831853f) * fade * 12000.f);
+			}
+			return WriteWAV(path, sampleRate, samples);
+		});
+
+	for (int i = 0; i < STORM_TEXTURE_COUNT; i++)
+	{
+		std::string path = ResourcesPath::TEXTURE + GetStormTextureName(i);
+		if (!std::filesystem::exists(path) && !WriteBMP(path, 256, 256, MakePattern(256, 256, 16, i)))
+		{
+			LogError("Failed to generate benchmark asset %s", path.c_str());
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+std::string BenchmarkAssets::GetStormTextureName(int index)
+{
+	return "bench_storm_" + std::to_string(index) + ".bmp";
+}
+
+std::string BenchmarkAssets::FindFont()
+{
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(ResourcesPath::FONT, error))
+	{
+		std::string extension = entry.path().extension().string();
+		if (entry.is_regular_file() && (extension == ".ttf" || extension == ".otf"))
+		{
+			return entry.path().filename().string();
+		}
+	}
+	return "";
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+
+/**
+ * @brief Files used by the benchmark scenarios.
+ *
+ * The textures and sounds are generated into the resource folders so the
+ * benchmark runs on a fresh checkout. Fonts can not be generated, the first
+ * one found in the font folder is used.
+ */
+namespace BenchmarkAssets
+{
+	const std::string SPRITE_TEXTURE = "bench_sprite.bmp";	///< 64x64 sprite.
+	const std::string SHEET_TEXTURE = "bench_sheet.bmp";	///< Single row sprite sheet.
+	const std::string BEEP_SOUND = "bench_beep.wav";		///< Short mono beep.
+	const int SHEET_FRAME_COUNT = 8;						///< Frames in the sprite sheet.
+	const int STORM_TEXTURE_COUNT = 16;						///< 256x256 textures used by the resource storm.
+
+	/**
+	 * @brief Writes the textures and sounds that do not exist yet.
+	 * @return True if every file exists afterwards.
+	 */
+	bool Generate();
+
+	/**
+	 * @brief Gets the file name of a resource storm texture.
+	 * @param index Index in range [0, STORM_TEXTURE_COUNT).
+	 */
+	std::string GetStormTextureName(int index);
+
+	/**
+	 * @brief Finds a font in the font folder.
+	 * @return File name of the first .ttf or .otf found, empty if there is none.
+	 */
+	std::string FindFont();
+}
@@ -0,0 +1,223 @@
+#include "BenchmarkCounters.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <glad/glad.h>
+
+static std::atomic<unsigned long long> s_allocations{ 0 };
+static std::atomic<unsigned long long> s_allocatedBytes{ 0 };
+static std::atomic<unsigned long long> s_glCalls{ 0 };
+static std::atomic<unsigned long long> s_drawCalls{ 0 };
+static std::atomic<unsigned long long> s_uploadBytes{ 0 };
+
+// count every heap allocation of the process, array and nothrow forms go through these by default
+void* operator new(std::size_t size)
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	void* memory = std::malloc(size ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+BenchmarkCounters GetBenchmarkCounters()
+{
+	BenchmarkCounters counters;
+	counters.allocations = s_allocations.load(std::memory_order_relaxed);
+	counters.allocatedBytes = s_allocatedBytes.load(std::memory_order_relaxed);
+	counters.glCalls = s_glCalls.load(std::memory_order_relaxed);
+	counters.drawCalls = s_drawCalls.load(std::memory_order_relaxed);
+	counters.uploadBytes = s_uploadBytes.load(std::memory_order_relaxed);
+	return counters;
+}
+
+BenchmarkCounters operator-(const BenchmarkCounters& after, const BenchmarkCounters& before)
+{
+	BenchmarkCounters delta;
+	delta.allocations = after.allocations - before.allocations;
+	delta.allocatedBytes = after.allocatedBytes - before.allocatedBytes;
+	delta.glCalls = after.glCalls - before.glCalls;
+	delta.drawCalls = after.drawCalls - before.drawCalls;
+	delta.uploadBytes = after.uploadBytes - before.uploadBytes;
+	return delta;
+}
+
+/**
+ * @brief Wraps a glad function pointer so every call is counted.
+ *
+ * The original pointer is kept per wrapped function, Install swaps it with Call.
+ */
+template <typename Proc>
+struct GLCallCounter;
+
+template <typename R, typename... Args>
+struct GLCallCounter<R(APIENTRYP)(Args...)>
+{
+	template <R(APIENTRYP* Slot)(Args...)>
+	struct Hook
+	{
+		static inline R(APIENTRYP original)(Args...) = nullptr;
+
+		static R APIENTRY Call(Args... args)
+		{
+			s_glCalls.fetch_add(1, std::memory_order_relaxed);
+			return original(args...);
+		}
+
+		static void Install()
+		{
+			if (*Slot && *Slot != &Call)
+			{
+				original = *Slot;
+				*Slot = &Call;
+			}
+		}
+	};
+};
+
+#define COUNT_GL_CALLS(name) GLCallCounter<decltype(glad_##name)>::Hook<&glad_##name>::Install()
+
+/**
+ * @brief Bytes per pixel of an uploaded image, for the common 8 bit formats.
+ */
+static unsigned long long GetPixelSize(GLenum format, GLenum type)
+{
+	unsigned long long channels = 4;
+	switch (format)
+	{
+	case GL_RED:
+	case GL_ALPHA:
+		channels = 1;
+		break;
+	case GL_RG:
+		channels = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+		channels = 3;
+		break;
+	default:
+		break;
+	}
+	return type == GL_FLOAT ? channels * 4 : channels;
+}
+
+static PFNGLBUFFERDATAPROC s_glBufferData = nullptr;
+static PFNGLBUFFERSUBDATAPROC s_glBufferSubData = nullptr;
+static PFNGLTEXIMAGE2DPROC s_glTexImage2D = nullptr;
+static PFNGLTEXSUBIMAGE2DPROC s_glTexSubImage2D = nullptr;
+static PFNGLDRAWARRAYSPROC s_glDrawArrays = nullptr;
+static PFNGLDRAWELEMENTSPROC s_glDrawElements = nullptr;
+
+static void APIENTRY CountedBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	s_glCalls.fetch_add(1, std::memory_order_relaxed);
+	// a null pointer only allocates storage
+	if (data)
+	{
+		s_uploadBytes.fetch_add(static_cast<unsigned long long>(size), std::memory_order_relaxed);
+	}
+	s_glBufferData(target, size, data, usage);
+}
+
+static void APIENTRY CountedBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	s_glCalls.fetch_add(1, std::memory_order_relaxed);
+	s_uploadBytes.fetch_add(static_cast<unsigned long long>(size), std::memory_order_relaxed);
+	s_glBufferSubData(target, offset, size, data);
+}
+
+static void APIENTRY CountedTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	s_glCalls.fetch_add(1, std::memory_order_relaxed);
+	if (pixels)
+	{
+		s_uploadBytes.fetch_add(static_cast<unsigned long long>(width) * height * GetPixelSize(format, type), std::memory_order_relaxed);
+	}
+	s_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+static void APIENTRY CountedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	s_glCalls.fetch_add(1, std::memory_order_relaxed);
+	s_uploadBytes.fetch_add(static_cast<unsigned long long>(width) * height * GetPixelSize(format, type), std::memory_order_relaxed);
+	s_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+static void APIENTRY CountedDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	s_glCalls.fetch_add(1, std::memory_order_relaxed);
+	s_drawCalls.fetch_add(1, std::memory_order_relaxed);
+	s_glDrawArrays(mode, first, count);
+}
+
+static void APIENTRY CountedDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	s_glCalls.fetch_add(1, std::memory_order_relaxed);
+	s_drawCalls.fetch_add(1, std::memory_order_relaxed);
+	s_glDrawElements(mode, count, type, indices);
+}
+
+void InstallGLCounters()
+{
+	if (s_glDrawElements)
+	{
+		return;
+	}
+
+	// calls that move data or draw
+	s_glBufferData = glad_glBufferData;
+	glad_glBufferData = &CountedBufferData;
+	s_glBufferSubData = glad_glBufferSubData;
+	glad_glBufferSubData = &CountedBufferSubData;
+	s_glTexImage2D = glad_glTexImage2D;
+	glad_glTexImage2D = &CountedTexImage2D;
+	s_glTexSubImage2D = glad_glTexSubImage2D;
+	glad_glTexSubImage2D = &CountedTexSubImage2D;
+	s_glDrawArrays = glad_glDrawArrays;
+	glad_glDrawArrays = &CountedDrawArrays;
+	s_glDrawElements = glad_glDrawElements;
+	glad_glDrawElements = &CountedDrawElements;
+
+	// state changes and object management used by the engine (ImGui loads its own pointers)
+	COUNT_GL_CALLS(glActiveTexture);
+	COUNT_GL_CALLS(glBindBuffer);
+	COUNT_GL_CALLS(glBindTexture);
+	COUNT_GL_CALLS(glBindVertexArray);
+	COUNT_GL_CALLS(glBlendFunc);
+	COUNT_GL_CALLS(glClear);
+	COUNT_GL_CALLS(glClearColor);
+	COUNT_GL_CALLS(glDeleteBuffers);
+	COUNT_GL_CALLS(glDeleteTextures);
+	COUNT_GL_CALLS(glDeleteVertexArrays);
+	COUNT_GL_CALLS(glDisable);
+	COUNT_GL_CALLS(glEnable);
+	COUNT_GL_CALLS(glEnableVertexAttribArray);
+	COUNT_GL_CALLS(glGenBuffers);
+	COUNT_GL_CALLS(glGenTextures);
+	COUNT_GL_CALLS(glGenVertexArrays);
+	COUNT_GL_CALLS(glGenerateMipmap);
+	COUNT_GL_CALLS(glGetUniformLocation);
+	COUNT_GL_CALLS(glPixelStorei);
+	COUNT_GL_CALLS(glTexParameteri);
+	COUNT_GL_CALLS(glUniform1f);
+	COUNT_GL_CALLS(glUniform1i);
+	COUNT_GL_CALLS(glUniformMatrix4fv);
+	COUNT_GL_CALLS(glUseProgram);
+	COUNT_GL_CALLS(glVertexAttribPointer);
+	COUNT_GL_CALLS(glViewport);
+}
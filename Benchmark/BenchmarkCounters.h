@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @struct BenchmarkCounters
+ * @brief Running totals of the work done by the engine, read before and after a frame.
+ */
+struct BenchmarkCounters
+{
+	unsigned long long allocations;		///< Calls to operator new.
+	unsigned long long allocatedBytes;	///< Bytes requested from operator new.
+	unsigned long long glCalls;			///< OpenGL calls made through glad.
+	unsigned long long drawCalls;		///< glDrawArrays/glDrawElements calls.
+	unsigned long long uploadBytes;		///< Bytes sent with glBufferData/glBufferSubData/glTexImage2D/glTexSubImage2D.
+};
+
+/**
+ * @brief Gets the current totals.
+ * @return A snapshot of the counters.
+ */
+BenchmarkCounters GetBenchmarkCounters();
+
+/**
+ * @brief Gets the difference between two snapshots.
+ * @param after The later snapshot.
+ * @param before The earlier snapshot.
+ * @return The work done between the two snapshots.
+ */
+BenchmarkCounters operator-(const BenchmarkCounters& after, const BenchmarkCounters& before);
+
+/**
+ * @brief Replaces the glad function pointers used by the engine with counting wrappers.
+ *
+ * Must be called once after glad is loaded, on the thread owning the OpenGL context.
+ */
+void InstallGLCounters();
@@ -0,0 +1,231 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <nlohmann/json.hpp>
+
+#include "BenchmarkCounters.h"
+#include "BenchmarkScenario.h"
+#include "GameStateMachine.h"
+#include "Logger.h"
+
+/**
+ * @brief Summarizes one measurement over the frames of a scenario.
+ */
+static nlohmann::json Summarize(const std::vector<BenchmarkFrame>& frames, const std::function<double(const BenchmarkFrame&)>& getValue)
+{
+	nlohmann::json summary;
+	if (frames.empty())
+	{
+		return summary;
+	}
+
+	std::vector<double> values;
+	values.reserve(frames.size());
+	double total = 0.0;
+	for (const auto& frame : frames)
+	{
+		values.push_back(getValue(frame));
+		total += values.back();
+	}
+	std::sort(values.begin(), values.end());
+
+	auto percentile = [&values](double p)
+		{
+			size_t index = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+			return values[std::min(index, values.size() - 1)];
+		};
+
+	summary["mean"] = total / values.size();
+	summary["p50"] = percentile(50.0);
+	summary["p95"] = percentile(95.0);
+	summary["p99"] = percentile(99.0);
+	summary["max"] = values.back();
+	summary["total"] = total;
+	return summary;
+}
+
+BenchmarkRunner::BenchmarkRunner(const std::vector<std::shared_ptr<BenchmarkScenario>>& scenarios, const std::string& outputPath, float frameTime) :
+	GameStateBase(GameStateType::STATE_CUSTOM), m_scenarios(scenarios), m_outputPath(outputPath), m_frameTime(frameTime)
+{
+	m_nextScenario = 0;
+	m_succeeded = false;
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+}
+
+void BenchmarkRunner::Init()
+{
+	// glad is loaded by now
+	InstallGLCounters();
+	RunNext();
+}
+
+void BenchmarkRunner::Update(float deltaTime)
+{
+}
+
+void BenchmarkRunner::Draw(float alpha)
+{
+}
+
+void BenchmarkRunner::Pause()
+{
+}
+
+void BenchmarkRunner::Resume()
+{
+	// a scenario just finished
+	RunNext();
+}
+
+void BenchmarkRunner::Exit()
+{
+}
+
+void BenchmarkRunner::OnKeyDown(const SDL_KeyboardEvent& keyevent)
+{
+}
+
+void BenchmarkRunner::OnKeyUp(const SDL_KeyboardEvent& keyevent)
+{
+}
+
+void BenchmarkRunner::OnMouseDown(const SDL_MouseButtonEvent& mouseevent)
+{
+}
+
+void BenchmarkRunner::OnMouseUp(const SDL_MouseButtonEvent& mouseevent)
+{
+}
+
+void BenchmarkRunner::OnMouseMove(const SDL_MouseMotionEvent& motionevent)
+{
+}
+
+void BenchmarkRunner::OnMouseScroll(const SDL_MouseWheelEvent& wheelevent)
+{
+}
+
+void BenchmarkRunner::OnControllerConnected()
+{
+}
+
+void BenchmarkRunner::OnControllerDisconnected()
+{
+}
+
+void BenchmarkRunner::OnControllerLeftJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkRunner::OnControllerLeftJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkRunner::OnControllerRightJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkRunner::OnControllerRightJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkRunner::OnControllerButtonDown(const SDL_ControllerButtonEvent& buttonEvent)
+{
+}
+
+void BenchmarkRunner::OnControllerButtonUp(const SDL_ControllerButtonEvent& buttonEvent)
+{
+}
+
+void BenchmarkRunner::OnLeftTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent)
+{
+}
+
+void BenchmarkRunner::OnRightTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent)
+{
+}
+
+bool BenchmarkRunner::Succeeded() const
+{
+	return m_succeeded;
+}
+
+void BenchmarkRunner::RunNext()
+{
+	if (m_nextScenario < m_scenarios.size())
+	{
+		GSM()->PushState(m_scenarios[m_nextScenario]);
+		m_nextScenario++;
+		return;
+	}
+
+	m_succeeded = WriteResults();
+	GSM()->Exit();
+}
+
+bool BenchmarkRunner::WriteResults() const
+{
+	nlohmann::json results;
+#if defined(_DEBUG)
+	results["configuration"] = "debug";
+#else
+	results["configuration"] = "release";
+#endif
+	results["frame_time_ms"] = m_frameTime * 1000.0;
+	results["scenarios"] = nlohmann::json::array();
+
+	for (const auto& scenario : m_scenarios)
+	{
+		const BenchmarkResult& result = scenario->GetResult();
+		nlohmann::json entry;
+		entry["name"] = result.name;
+		entry["skipped"] = result.skipped;
+		if (result.skipped)
+		{
+			entry["skip_reason"] = result.skipReason;
+			results["scenarios"].push_back(entry);
+			continue;
+		}
+
+		const auto& frames = result.frames;
+		entry["frames"] = frames.size();
+		entry["cpu_ms"] = Summarize(frames, [](const BenchmarkFrame& f) { return f.updateMs + f.drawMs; });
+		entry["frame_ms"] = Summarize(frames, [](const BenchmarkFrame& f) { return f.frameMs; });
+		entry["update_ms"] = Summarize(frames, [](const BenchmarkFrame& f) { return f.updateMs; });
+		entry["draw_ms"] = Summarize(frames, [](const BenchmarkFrame& f) { return f.drawMs; });
+		entry["swap_ms"] = Summarize(frames, [](const BenchmarkFrame& f) { return f.swapMs; });
+		entry["allocations"] = Summarize(frames, [](const BenchmarkFrame& f) { return (double)f.counters.allocations; });
+		entry["allocated_bytes"] = Summarize(frames, [](const BenchmarkFrame& f) { return (double)f.counters.allocatedBytes; });
+		entry["gl_calls"] = Summarize(frames, [](const BenchmarkFrame& f) { return (double)f.counters.glCalls; });
+		entry["draw_calls"] = Summarize(frames, [](const BenchmarkFrame& f) { return (double)f.counters.drawCalls; });
+		entry["upload_bytes"] = Summarize(frames, [](const BenchmarkFrame& f) { return (double)f.counters.uploadBytes; });
+		for (const auto& metric : result.metrics)
+		{
+			entry["metrics"][metric.first] = metric.second;
+		}
+		results["scenarios"].push_back(entry);
+
+		LogInfo("%-24s cpu p50 %7.3f ms  p99 %7.3f ms  allocs %8.1f  gl calls %8.1f  upload %10.0f B",
+			result.name.c_str(), (double)entry["cpu_ms"]["p50"], (double)entry["cpu_ms"]["p99"],
+			(double)entry["allocations"]["mean"], (double)entry["gl_calls"]["mean"], (double)entry["upload_bytes"]["mean"]);
+		for (const auto& metric : result.metrics)
+		{
+			LogInfo("%-24s %s %.3f", "", metric.first.c_str(), metric.second);
+		}
+	}
+
+	std::ofstream file(m_outputPath);
+	if (!file.is_open())
+	{
+		LogError("Failed to write benchmark results to %s", m_outputPath.c_str());
+		return false;
+	}
+	file << results.dump(4);
+	LogSuccess("Benchmark results written to %s", m_outputPath.c_str());
+	return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GameStateBase.h"
+
+class BenchmarkScenario;
+
+/**
+ * @class BenchmarkRunner
+ * @brief Bottom game state pushing the scenarios one after the other.
+ *
+ * Each scenario pops itself when done, the runner is resumed, stores the result and
+ * pushes the next one. After the last scenario the results are written as JSON and
+ * the game exits.
+ */
+class BenchmarkRunner final : public GameStateBase
+{
+public:
+	/**
+	 * @brief Constructs the runner.
+	 * @param scenarios The scenarios to run, in order.
+	 * @param outputPath Path of the JSON results.
+	 * @param frameTime The fixed frame time the game runs at, reported in the results.
+	 */
+	BenchmarkRunner(const std::vector<std::shared_ptr<BenchmarkScenario>>& scenarios, const std::string& outputPath, float frameTime);
+	~BenchmarkRunner() override;
+
+	void Init() override;
+	void Update(float deltaTime) override;
+	void Draw(float alpha) override;
+	void Pause() override;
+	void Resume() override;
+	void Exit() override;
+
+	void OnKeyDown(const SDL_KeyboardEvent& keyevent) override;
+	void OnKeyUp(const SDL_KeyboardEvent& keyevent) override;
+	void OnMouseDown(const SDL_MouseButtonEvent& mouseevent) override;
+	void OnMouseUp(const SDL_MouseButtonEvent& mouseevent) override;
+	void OnMouseMove(const SDL_MouseMotionEvent& motionevent) override;
+	void OnMouseScroll(const SDL_MouseWheelEvent& wheelevent) override;
+	void OnControllerConnected() override;
+	void OnControllerDisconnected() override;
+	void OnControllerLeftJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerLeftJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerRightJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerRightJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerButtonDown(const SDL_ControllerButtonEvent& buttonEvent) override;
+	void OnControllerButtonUp(const SDL_ControllerButtonEvent& buttonEvent) override;
+	void OnLeftTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent) override;
+	void OnRightTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent) override;
+
+	/**
+	 * @brief Checks if every scenario ran and the results were written.
+	 */
+	bool Succeeded() const;
+
+private:
+	std::vector<std::shared_ptr<BenchmarkScenario>> m_scenarios;	///< Scenarios to run.
+	size_t m_nextScenario;											///< Index of the next scenario to push.
+	std::string m_outputPath;										///< Where the JSON is written.
+	float m_frameTime;												///< Fixed frame time of the run.
+	bool m_succeeded;												///< True once the results were written.
+
+	/**
+	 * @brief Pushes the next scenario, or writes the results and exits when there is none.
+	 */
+	void RunNext();
+
+	/**
+	 * @brief Writes the results of every scenario.
+	 * @return True if the file was written.
+	 */
+	bool WriteResults() const;
+};
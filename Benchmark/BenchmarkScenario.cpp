@@ -0,0 +1,200 @@
+#include "BenchmarkScenario.h"
+
+#include "Camera.h"
+#include "Game.h"
+#include "GameStateMachine.h"
+#include "Logger.h"
+
+BenchmarkScenario::BenchmarkScenario(const std::string& name, int frameCount, int warmupFrames) :
+	GameStateBase(GameStateType::STATE_CUSTOM), m_frameCount(frameCount), m_warmupFrames(warmupFrames)
+{
+	m_result.name = name;
+	m_result.skipped = false;
+	m_lastCounters = BenchmarkCounters();
+	m_frame = 0;
+}
+
+BenchmarkScenario::~BenchmarkScenario()
+{
+}
+
+void BenchmarkScenario::Init()
+{
+	LogInfo("Running scenario %s", m_result.name.c_str());
+
+	m_camera = std::make_shared<Camera>();
+	m_camera->SetOrthographicProjection(0.f, (float)GAME()->GetWindowWidth(), 0.f, (float)GAME()->GetWindowHeight());
+
+	m_frame = 0;
+	m_result.frames.clear();
+	m_result.metrics.clear();
+	m_result.frames.reserve(m_frameCount);
+	if (!Setup())
+	{
+		m_result.skipped = true;
+	}
+}
+
+void BenchmarkScenario::Update(float deltaTime)
+{
+	if (m_result.skipped)
+	{
+		GSM()->PopState();
+		return;
+	}
+
+	// the game runs exactly one step per frame, so the counters are sampled here once per frame
+	if (m_frame == m_warmupFrames)
+	{
+		m_lastCounters = GetBenchmarkCounters();
+	}
+	else if (m_frame > m_warmupFrames)
+	{
+		BenchmarkCounters counters = GetBenchmarkCounters();
+		BenchmarkFrame frame = {};
+		frame.counters = counters - m_lastCounters;
+
+		// telemetry records a frame after its swap, the last sample is the frame the counters cover
+		const FrameSample* sample = GAME()->GetTelemetry()->GetLastSample();
+		if (sample)
+		{
+			frame.frameMs = sample->frameMs;
+			frame.updateMs = sample->updateMs;
+			frame.drawMs = sample->drawMs;
+			frame.swapMs = sample->swapMs;
+		}
+		m_result.frames.push_back(frame);
+		m_lastCounters = counters;
+	}
+
+	if (m_frame == m_warmupFrames + m_frameCount)
+	{
+		Finish();
+		return;
+	}
+
+	Step(deltaTime);
+	m_frame++;
+}
+
+void BenchmarkScenario::Draw(float alpha)
+{
+	if (!m_result.skipped)
+	{
+		Render();
+	}
+}
+
+void BenchmarkScenario::Pause()
+{
+}
+
+void BenchmarkScenario::Resume()
+{
+}
+
+void BenchmarkScenario::Exit()
+{
+	Teardown();
+	m_camera = nullptr;
+}
+
+void BenchmarkScenario::OnKeyDown(const SDL_KeyboardEvent& keyevent)
+{
+}
+
+void BenchmarkScenario::OnKeyUp(const SDL_KeyboardEvent& keyevent)
+{
+}
+
+void BenchmarkScenario::OnMouseDown(const SDL_MouseButtonEvent& mouseevent)
+{
+}
+
+void BenchmarkScenario::OnMouseUp(const SDL_MouseButtonEvent& mouseevent)
+{
+}
+
+void BenchmarkScenario::OnMouseMove(const SDL_MouseMotionEvent& motionevent)
+{
+}
+
+void BenchmarkScenario::OnMouseScroll(const SDL_MouseWheelEvent& wheelevent)
+{
+}
+
+void BenchmarkScenario::OnControllerConnected()
+{
+}
+
+void BenchmarkScenario::OnControllerDisconnected()
+{
+}
+
+void BenchmarkScenario::OnControllerLeftJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkScenario::OnControllerLeftJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkScenario::OnControllerRightJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkScenario::OnControllerRightJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent)
+{
+}
+
+void BenchmarkScenario::OnControllerButtonDown(const SDL_ControllerButtonEvent& buttonEvent)
+{
+}
+
+void BenchmarkScenario::OnControllerButtonUp(const SDL_ControllerButtonEvent& buttonEvent)
+{
+}
+
+void BenchmarkScenario::OnLeftTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent)
+{
+}
+
+void BenchmarkScenario::OnRightTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent)
+{
+}
+
+const std::string& BenchmarkScenario::GetName() const
+{
+	return m_result.name;
+}
+
+const BenchmarkResult& BenchmarkScenario::GetResult() const
+{
+	return m_result;
+}
+
+void BenchmarkScenario::Teardown()
+{
+}
+
+void BenchmarkScenario::Skip(const std::string& reason)
+{
+	m_result.skipped = true;
+	m_result.skipReason = reason;
+	LogWarning("Skipping scenario %s: %s", m_result.name.c_str(), reason.c_str());
+}
+
+bool BenchmarkScenario::IsMeasuring() const
+{
+	return m_frame >= m_warmupFrames;
+}
+
+void BenchmarkScenario::SetMetric(const std::string& name, double value)
+{
+	m_result.metrics.emplace_back(name, value);
+}
+
+void BenchmarkScenario::Finish()
+{
+	GSM()->PopState();
+}
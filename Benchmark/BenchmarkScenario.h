@@ -0,0 +1,149 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GameStateBase.h"
+#include "BenchmarkCounters.h"
+
+class Camera;
+
+/**
+ * @struct BenchmarkFrame
+ * @brief Measurements of one frame of a scenario.
+ */
+struct BenchmarkFrame
+{
+	float frameMs;					///< Wall time of the frame.
+	float updateMs;					///< Time spent in the simulation step.
+	float drawMs;					///< Time spent drawing.
+	float swapMs;					///< Time spent in the buffer swap.
+	BenchmarkCounters counters;		///< Allocations, GL calls and uploads of the frame.
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief Everything a scenario measured.
+ */
+struct BenchmarkResult
+{
+	std::string name;					///< Name of the scenario.
+	bool skipped;						///< True if the scenario could not be set up.
+	std::string skipReason;				///< Why the scenario was skipped.
+	std::vector<BenchmarkFrame> frames;	///< One entry per measured frame.
+	std::vector<std::pair<std::string, double>> metrics;	///< Values specific to the scenario, by name.
+};
+
+/**
+ * @class BenchmarkScenario
+ * @brief Game state running a scripted workload for a fixed number of frames.
+ *
+ * Scenarios go through the real Game and GameStateMachine loop. The first frames are
+ * a warm-up, the following ones are measured using the frame telemetry for timings and
+ * the benchmark counters for allocations, GL calls and uploaded bytes. When done,
+ * the scenario pops itself and the runner collects the result.
+ */
+class BenchmarkScenario : public GameStateBase
+{
+public:
+	/**
+	 * @brief Constructs a scenario.
+	 * @param name Name used in the results.
+	 * @param frameCount Number of measured frames.
+	 * @param warmupFrames Number of frames run before measuring.
+	 */
+	BenchmarkScenario(const std::string& name, int frameCount, int warmupFrames);
+	~BenchmarkScenario() override;
+
+	void Init() override;
+	void Update(float deltaTime) override;
+	void Draw(float alpha) override;
+	void Pause() override;
+	void Resume() override;
+	void Exit() override;
+
+	void OnKeyDown(const SDL_KeyboardEvent& keyevent) override;
+	void OnKeyUp(const SDL_KeyboardEvent& keyevent) override;
+	void OnMouseDown(const SDL_MouseButtonEvent& mouseevent) override;
+	void OnMouseUp(const SDL_MouseButtonEvent& mouseevent) override;
+	void OnMouseMove(const SDL_MouseMotionEvent& motionevent) override;
+	void OnMouseScroll(const SDL_MouseWheelEvent& wheelevent) override;
+	void OnControllerConnected() override;
+	void OnControllerDisconnected() override;
+	void OnControllerLeftJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerLeftJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerRightJoystickMotionX(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerRightJoystickMotionY(const SDL_ControllerAxisEvent& joystickEvent) override;
+	void OnControllerButtonDown(const SDL_ControllerButtonEvent& buttonEvent) override;
+	void OnControllerButtonUp(const SDL_ControllerButtonEvent& buttonEvent) override;
+	void OnLeftTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent) override;
+	void OnRightTriggerMotion(const SDL_ControllerAxisEvent& triggerEvent) override;
+
+	/**
+	 * @brief Gets the name of the scenario.
+	 */
+	const std::string& GetName() const;
+
+	/**
+	 * @brief Gets the measurements, complete once the scenario exited.
+	 */
+	const BenchmarkResult& GetResult() const;
+
+protected:
+	/**
+	 * @brief Creates the objects of the workload.
+	 * @return False if the scenario can not run, after calling Skip.
+	 */
+	virtual bool Setup() = 0;
+
+	/**
+	 * @brief Runs one simulation step of the workload.
+	 * @param deltaTime The fixed step.
+	 */
+	virtual void Step(float deltaTime) = 0;
+
+	/**
+	 * @brief Draws the workload.
+	 */
+	virtual void Render() = 0;
+
+	/**
+	 * @brief Frees the objects of the workload.
+	 */
+	virtual void Teardown();
+
+	/**
+	 * @brief Marks the scenario as skipped.
+	 * @param reason Reported in the results.
+	 */
+	void Skip(const std::string& reason);
+
+	/**
+	 * @brief Checks if the current step is measured.
+	 * @return False during the warm-up.
+	 */
+	bool IsMeasuring() const;
+
+	/**
+	 * @brief Reports a value specific to the scenario.
+	 * @param name Name used in the results.
+	 * @param value The value.
+	 */
+	void SetMetric(const std::string& name, double value);
+
+	std::shared_ptr<Camera> m_camera;	///< Orthographic camera covering the window.
+
+private:
+	BenchmarkResult m_result;			///< Measurements.
+	BenchmarkCounters m_lastCounters;	///< Counters at the start of the current frame.
+	int m_frameCount;					///< Number of measured frames.
+	int m_warmupFrames;					///< Number of frames before measuring.
+	int m_frame;						///< Frames run so far.
+
+	/**
+	 * @brief Pops the scenario.
+	 */
+	void Finish();
+};
@@ -0,0 +1,544 @@
+#include "BenchmarkScenarios.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "BenchmarkAssets.h"
+#include "BatchRenderer.h"
+#include "Game.h"
+#include "Renderer.h"
+#include "ResourceManager.h"
+#include "Sound.h"
+#include "SoundPlayer.h"
+#include "Sprite2D.h"
+#include "SpriteAnimation.h"
+#include "Text.h"
+#include "TextView.h"
+#include "Texture.h"
+
+// every run places the objects the same way
+static const unsigned int BENCHMARK_SEED = 1234;
+
+SpriteScenario::SpriteScenario(const std::string& name, int frameCount, int warmupFrames, int spriteCount, bool moving, int textureCount, bool atlas) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_spriteCount(spriteCount), m_moving(moving),
+	m_textureCount(std::min(textureCount, BenchmarkAssets::STORM_TEXTURE_COUNT)), m_atlas(atlas)
+{
+}
+
+bool SpriteScenario::Setup()
+{
+	m_textureNames.clear();
+	if (m_textureCount > 1)
+	{
+		for (int i = 0; i < m_textureCount; i++)
+		{
+			m_textureNames.push_back(BenchmarkAssets::GetStormTextureName(i));
+		}
+	}
+	else
+	{
+		m_textureNames.push_back(BenchmarkAssets::SPRITE_TEXTURE);
+	}
+
+	std::vector<std::shared_ptr<Texture>> textures;
+	for (const auto& textureName : m_textureNames)
+	{
+		if (m_atlas)
+		{
+			RESOURCE()->LoadAtlasTexture(textureName);
+		}
+		else
+		{
+			RESOURCE()->LoadTexture(textureName);
+		}
+
+		auto texture = RESOURCE()->GetTexture(textureName);
+		if (!texture)
+		{
+			Skip("missing sprite texture");
+			return false;
+		}
+		textures.push_back(texture);
+	}
+
+	RESOURCE()->LoadShader("quad_batch");
+	auto shader = RESOURCE()->GetShader("quad_batch");
+	if (!shader)
+	{
+		Skip("missing quad_batch shader");
+		return false;
+	}
+
+	m_batchRenderer = std::make_shared<BatchRenderer>(m_spriteCount * 4, m_camera, shader);
+
+	std::mt19937 random(BENCHMARK_SEED);
+	std::uniform_real_distribution<float> x(0.f, (float)GAME()->GetWindowWidth());
+	std::uniform_real_distribution<float> y(0.f, (float)GAME()->GetWindowHeight());
+	std::uniform_real_distribution<float> speed(-200.f, 200.f);
+
+	m_sprites.reserve(m_spriteCount);
+	m_velocities.reserve(m_spriteCount);
+	for (int i = 0; i < m_spriteCount; i++)
+	{
+		auto sprite = std::make_shared<Sprite2D>(textures[i % textures.size()]);
+		sprite->SetPosition(x(random), y(random));
+		sprite->SetSize(16.f, 16.f);
+		m_batchRenderer->AddObject(sprite);
+		m_sprites.push_back(sprite);
+		m_velocities.push_back(glm::vec2(speed(random), speed(random)));
+	}
+	return true;
+}
+
+void SpriteScenario::Step(float deltaTime)
+{
+	if (!m_moving)
+	{
+		return;
+	}
+
+	float width = (float)GAME()->GetWindowWidth();
+	float height = (float)GAME()->GetWindowHeight();
+	for (size_t i = 0; i < m_sprites.size(); i++)
+	{
+		// bounce on the window borders
+		glm::vec3 position = m_sprites[i]->GetPosition();
+		glm::vec2& velocity = m_velocities[i];
+		position.x += velocity.x * deltaTime;
+		position.y += velocity.y * deltaTime;
+		if (position.x < 0.f || position.x > width)
+		{
+			velocity.x = -velocity.x;
+		}
+		if (position.y < 0.f || position.y > height)
+		{
+			velocity.y = -velocity.y;
+		}
+		m_sprites[i]->SetPosition(position);
+	}
+}
+
+void SpriteScenario::Render()
+{
+	m_batchRenderer->Render();
+}
+
+void SpriteScenario::Teardown()
+{
+	m_batchRenderer = nullptr;
+	m_sprites.clear();
+	m_velocities.clear();
+	for (const auto& textureName : m_textureNames)
+	{
+		RESOURCE()->FreeTexture(textureName);
+	}
+}
+
+AnimationScenario::AnimationScenario(const std::string& name, int frameCount, int warmupFrames, int animationCount) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_animationCount(animationCount)
+{
+}
+
+bool AnimationScenario::Setup()
+{
+	RESOURCE()->LoadTexture(BenchmarkAssets::SHEET_TEXTURE);
+	auto texture = RESOURCE()->GetTexture(BenchmarkAssets::SHEET_TEXTURE);
+	if (!texture)
+	{
+		Skip("missing sprite sheet texture");
+		return false;
+	}
+
+	m_renderer = std::make_shared<AnimationRenderer>();
+	m_renderer->SetCamera(m_camera);
+
+	std::mt19937 random(BENCHMARK_SEED);
+	std::uniform_real_distribution<float> x(0.f, (float)GAME()->GetWindowWidth());
+	std::uniform_real_distribution<float> y(0.f, (float)GAME()->GetWindowHeight());
+	std::uniform_real_distribution<float> frameTime(0.05f, 0.15f);
+
+	m_animations.reserve(m_animationCount);
+	for (int i = 0; i < m_animationCount; i++)
+	{
+		auto animation = std::make_shared<SpriteAnimation>(texture, frameTime(random), BenchmarkAssets::SHEET_FRAME_COUNT);
+		animation->SetPosition(x(random), y(random));
+		animation->SetSize(32.f, 32.f);
+		m_animations.push_back(animation);
+	}
+	return true;
+}
+
+void AnimationScenario::Step(float deltaTime)
+{
+	for (auto& animation : m_animations)
+	{
+		animation->Update(deltaTime);
+	}
+}
+
+void AnimationScenario::Render()
+{
+	for (auto& animation : m_animations)
+	{
+		m_renderer->AddObject(animation);
+	}
+	m_renderer->Render();
+}
+
+void AnimationScenario::Teardown()
+{
+	m_renderer = nullptr;
+	m_animations.clear();
+	RESOURCE()->FreeTexture(BenchmarkAssets::SHEET_TEXTURE);
+}
+
+TextChurnScenario::TextChurnScenario(const std::string& name, int frameCount, int warmupFrames, int textCount, const std::string& fontName, bool distanceField) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_textCount(textCount), m_fontName(fontName), m_distanceField(distanceField), m_step(0)
+{
+}
+
+bool TextChurnScenario::Setup()
+{
+	if (m_fontName.empty())
+	{
+		Skip("no font found in " + ResourcesPath::FONT + ", pass one with --font");
+		return false;
+	}
+
+	const int fontSize = 16;
+	RESOURCE()->LoadFont(m_fontName, fontSize);
+	TTF_Font* font = RESOURCE()->GetFont(m_fontName, fontSize);
+	if (!font)
+	{
+		Skip("failed to open font " + m_fontName);
+		return false;
+	}
+
+	if (m_distanceField)
+	{
+		m_renderer = std::make_shared<TextRenderer>();
+	}
+	else
+	{
+		m_renderer = std::make_shared<SpriteRenderer>();
+	}
+	m_renderer->SetCamera(m_camera);
+
+	// lay the texts out in a grid of 10 columns, wrapping around when the window is full
+	int rowCount = std::max(GAME()->GetWindowHeight() / 20, 1);
+	m_texts.reserve(m_textCount);
+	for (int i = 0; i < m_textCount; i++)
+	{
+		auto text = std::make_shared<Text>("0", font, fontSize, SDL_Color{ 0, 0, 0, 255 }, GL_LINEAR, m_distanceField);
+		text->SetPosition(100.f + (i % 10) * 140.f, ((i / 10) % rowCount) * 20.f + 10.f);
+		m_texts.push_back(text);
+	}
+	m_step = 0;
+	return true;
+}
+
+void TextChurnScenario::Step(float deltaTime)
+{
+	// every text gets a new string every step, like score and debug counters
+	m_step++;
+	for (size_t i = 0; i < m_texts.size(); i++)
+	{
+		m_texts[i]->SetText("Score " + std::to_string(m_step * 7 + i * 13));
+		if (m_distanceField)
+		{
+			m_texts[i]->SetFontSize(12 + static_cast<int>((m_step + i) % 12));
+		}
+	}
+}
+
+void TextChurnScenario::Render()
+{
+	for (auto& text : m_texts)
+	{
+		m_renderer->AddObject(text);
+	}
+	m_renderer->Render();
+}
+
+void TextChurnScenario::Teardown()
+{
+	m_renderer = nullptr;
+	m_texts.clear();
+}
+
+TextLogScenario::TextLogScenario(const std::string& name, int frameCount, int warmupFrames, int lineCount, const std::string& fontName) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_lineCount(lineCount), m_fontName(fontName), m_step(0)
+{
+}
+
+bool TextLogScenario::Setup()
+{
+	if (m_fontName.empty())
+	{
+		Skip("no font found in " + ResourcesPath::FONT + ", pass one with --font");
+		return false;
+	}
+
+	// the viewport shows the same 40 lines whatever the size of the log
+	const int fontSize = 16;
+	m_view = std::make_shared<TextView>(m_fontName, fontSize, static_cast<size_t>(m_lineCount), 40);
+	if (!RESOURCE()->GetFont(m_fontName, fontSize))
+	{
+		Skip("failed to open font " + m_fontName);
+		m_view = nullptr;
+		return false;
+	}
+	for (int i = 0; i < m_lineCount; i++)
+	{
+		m_view->AppendLine("[" + std::to_string(i) + "] Player joined the game");
+	}
+	m_view->SetPosition(10.f, 10.f);
+
+	m_renderer = std::make_shared<SpriteRenderer>();
+	m_renderer->SetCamera(m_camera);
+	m_step = 0;
+	return true;
+}
+
+void TextLogScenario::Step(float deltaTime)
+{
+	m_step++;
+	m_view->AppendLine("[" + std::to_string(m_lineCount + m_step) + "] Score " + std::to_string(m_step * 7));
+}
+
+void TextLogScenario::Render()
+{
+	m_view->Draw(m_renderer);
+	m_renderer->Render();
+}
+
+void TextLogScenario::Teardown()
+{
+	m_renderer = nullptr;
+	m_view = nullptr;
+}
+
+SoundTriggerScenario::SoundTriggerScenario(const std::string& name, int frameCount, int warmupFrames, int triggersPerStep) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_triggersPerStep(triggersPerStep)
+{
+}
+
+bool SoundTriggerScenario::Setup()
+{
+	RESOURCE()->LoadSound(BenchmarkAssets::BEEP_SOUND);
+	if (!RESOURCE()->GetSound(BenchmarkAssets::BEEP_SOUND))
+	{
+		Skip("missing beep sound");
+		return false;
+	}
+	return true;
+}
+
+void SoundTriggerScenario::Step(float deltaTime)
+{
+	auto sound = RESOURCE()->GetSound(BenchmarkAssets::BEEP_SOUND);
+	for (int i = 0; i < m_triggersPerStep; i++)
+	{
+		SOUNDPLAYER()->Play(sound);
+	}
+}
+
+void SoundTriggerScenario::Render()
+{
+}
+
+void SoundTriggerScenario::Teardown()
+{
+	SOUNDPLAYER()->StopAll();
+	RESOURCE()->FreeSound(BenchmarkAssets::BEEP_SOUND);
+}
+
+AudioMixScenario::AudioMixScenario(const std::string& name, int frameCount, int warmupFrames, int voiceCount, unsigned int sampleRate, unsigned int bufferSize) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_voiceCount(voiceCount), m_sampleRate(sampleRate), m_bufferSize(bufferSize),
+	m_replacedPlayer(false), m_mixSeconds(0.0), m_audioSeconds(0.0), m_buffers(0)
+{
+}
+
+bool AudioMixScenario::Setup()
+{
+	// a sound stops itself through the engine that played it, so the beep is freed before
+	// that engine is destroyed and loaded again once the new one runs
+	SOUNDPLAYER()->StopAll();
+	RESOURCE()->FreeSound(BenchmarkAssets::BEEP_SOUND);
+
+	// the game player is replaced by one mixing into memory
+	SoundPlayerConfig config;
+	config.nullDriver = true;
+	config.sampleRate = m_sampleRate;
+	config.bufferSize = m_bufferSize;
+	config.maxVoices = m_voiceCount;
+	SOUNDPLAYER()->Deinit();
+	SOUNDPLAYER()->Init(config);
+	m_replacedPlayer = true;
+
+	RESOURCE()->LoadSound(BenchmarkAssets::BEEP_SOUND);
+	auto sound = RESOURCE()->GetSound(BenchmarkAssets::BEEP_SOUND);
+	if (!sound)
+	{
+		Skip("missing beep sound");
+		return false;
+	}
+
+	// triggers of a sound in one frame are merged, each update starts one voice
+	sound->SetLoop(true);
+	for (int i = 0; i < m_voiceCount; i++)
+	{
+		SOUNDPLAYER()->Play(sound);
+		SOUNDPLAYER()->Update();
+	}
+
+	m_buffer.assign(static_cast<size_t>(SOUNDPLAYER()->GetBufferSize()) * SOUNDPLAYER()->GetChannelCount(), 0.f);
+	m_mixSeconds = 0.0;
+	m_audioSeconds = 0.0;
+	m_buffers = 0;
+	return true;
+}
+
+void AudioMixScenario::Step(float deltaTime)
+{
+	// a frame worth of audio at 60 frames per second
+	unsigned int sampleRate = SOUNDPLAYER()->GetSampleRate();
+	unsigned int bufferSize = SOUNDPLAYER()->GetBufferSize();
+	unsigned int bufferCount = std::max((sampleRate / 60 + bufferSize - 1) / bufferSize, 1u);
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < bufferCount; i++)
+	{
+		SOUNDPLAYER()->Mix(m_buffer.data(), bufferSize);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (IsMeasuring())
+	{
+		m_mixSeconds += elapsed.count();
+		m_audioSeconds += static_cast<double>(bufferCount) * bufferSize / sampleRate;
+		m_buffers += bufferCount;
+	}
+}
+
+void AudioMixScenario::Render()
+{
+}
+
+void AudioMixScenario::Teardown()
+{
+	if (!m_replacedPlayer)
+	{
+		return;
+	}
+
+	if (m_mixSeconds > 0.0)
+	{
+		SetMetric("voices", static_cast<double>(SOUNDPLAYER()->GetVoiceCount()));
+		SetMetric("sample_rate", SOUNDPLAYER()->GetSampleRate());
+		SetMetric("buffer_size", SOUNDPLAYER()->GetBufferSize());
+		SetMetric("real_time_factor", m_audioSeconds / m_mixSeconds);
+		SetMetric("mix_us_per_buffer", m_mixSeconds * 1000000.0 / m_buffers);
+	}
+
+	// the beep is freed while the engine that played it still exists
+	SOUNDPLAYER()->StopAll();
+	RESOURCE()->FreeSound(BenchmarkAssets::BEEP_SOUND);
+	SOUNDPLAYER()->Deinit();
+	SOUNDPLAYER()->Init(GAME()->GetSoundConfig());
+	m_replacedPlayer = false;
+	m_buffer.clear();
+}
+
+ResourceStormScenario::ResourceStormScenario(const std::string& name, int frameCount, int warmupFrames, int texturesPerStep, int soundsPerStep, bool async) :
+	BenchmarkScenario(name, frameCount, warmupFrames), m_texturesPerStep(texturesPerStep), m_soundsPerStep(soundsPerStep), m_async(async), m_step(0)
+{
+}
+
+bool ResourceStormScenario::Setup()
+{
+	m_step = 0;
+	return true;
+}
+
+void ResourceStormScenario::Step(float deltaTime)
+{
+	if (m_async)
+	{
+		// free the textures that finished streaming, keep the others loading
+		auto it = std::remove_if(m_loadedTextures.begin(), m_loadedTextures.end(), [](const std::string& name)
+			{
+				auto texture = RESOURCE()->GetTexture(name);
+				if (!texture || texture->IsReady())
+				{
+					RESOURCE()->FreeTexture(name);
+					return true;
+				}
+				return false;
+			});
+		m_loadedTextures.erase(it, m_loadedTextures.end());
+		for (const auto& name : m_loadedSounds)
+		{
+			RESOURCE()->FreeSound(name);
+		}
+		m_loadedSounds.clear();
+	}
+	else
+	{
+		// what the last step loaded goes away, a new set comes in
+		FreeLoaded();
+	}
+
+	for (int i = 0; i < m_texturesPerStep; i++)
+	{
+		std::string name = BenchmarkAssets::GetStormTextureName((m_step * m_texturesPerStep + i) % BenchmarkAssets::STORM_TEXTURE_COUNT);
+		if (m_async)
+		{
+			// a name still streaming is not requested twice
+			if (std::find(m_loadedTextures.begin(), m_loadedTextures.end(), name) == m_loadedTextures.end())
+			{
+				RESOURCE()->LoadTextureAsync(name);
+				m_loadedTextures.push_back(name);
+			}
+		}
+		else
+		{
+			RESOURCE()->LoadTexture(name);
+			m_loadedTextures.push_back(name);
+		}
+	}
+	for (int i = 0; i < m_soundsPerStep; i++)
+	{
+		// there is only one sound file, free it first so the cache does not hide the load
+		RESOURCE()->FreeSound(BenchmarkAssets::BEEP_SOUND);
+		RESOURCE()->LoadSound(BenchmarkAssets::BEEP_SOUND);
+	}
+	if (m_soundsPerStep > 0)
+	{
+		m_loadedSounds.push_back(BenchmarkAssets::BEEP_SOUND);
+	}
+	m_step++;
+}
+
+void ResourceStormScenario::Render()
+{
+}
+
+void ResourceStormScenario::Teardown()
+{
+	FreeLoaded();
+}
+
+void ResourceStormScenario::FreeLoaded()
+{
+	for (const auto& name : m_loadedTextures)
+	{
+		RESOURCE()->FreeTexture(name);
+	}
+	for (const auto& name : m_loadedSounds)
+	{
+		RESOURCE()->FreeSound(name);
+	}
+	m_loadedTextures.clear();
+	m_loadedSounds.clear();
+}
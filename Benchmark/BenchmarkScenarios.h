@@ -0,0 +1,194 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BenchmarkScenario.h"
+
+class BaseObject;
+class BatchRenderer;
+class Renderer;
+class SpriteAnimation;
+class Text;
+class TextView;
+
+/**
+ * @class SpriteScenario
+ * @brief Draws many sprites through the batch renderer, either static or bouncing around the screen.
+ *
+ * The sprites can cycle through several textures, loaded either as separate textures
+ * or into the texture atlas, to compare the draw calls of both.
+ */
+class SpriteScenario final : public BenchmarkScenario
+{
+public:
+	SpriteScenario(const std::string& name, int frameCount, int warmupFrames, int spriteCount, bool moving, int textureCount = 1, bool atlas = false);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_spriteCount;										///< Number of sprites.
+	bool m_moving;											///< True to move every sprite each step.
+	int m_textureCount;										///< Number of different textures, more than one uses the storm textures.
+	bool m_atlas;											///< True to load the textures into the texture atlas.
+	std::vector<std::string> m_textureNames;				///< The textures used by the sprites.
+	std::shared_ptr<BatchRenderer> m_batchRenderer;			///< Renderer holding all the sprites.
+	std::vector<std::shared_ptr<BaseObject>> m_sprites;		///< The sprites.
+	std::vector<glm::vec2> m_velocities;					///< Velocity of each sprite in pixels per second.
+};
+
+/**
+ * @class AnimationScenario
+ * @brief Updates and draws animated sprites through the animation renderer.
+ */
+class AnimationScenario final : public BenchmarkScenario
+{
+public:
+	AnimationScenario(const std::string& name, int frameCount, int warmupFrames, int animationCount);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_animationCount;										///< Number of animations.
+	std::shared_ptr<Renderer> m_renderer;						///< Animation renderer.
+	std::vector<std::shared_ptr<SpriteAnimation>> m_animations;	///< The animations.
+};
+
+/**
+ * @class TextChurnScenario
+ * @brief Changes the string of many text objects every step.
+ *
+ * With distance fields the texts also zoom, which only rescales them.
+ */
+class TextChurnScenario final : public BenchmarkScenario
+{
+public:
+	TextChurnScenario(const std::string& name, int frameCount, int warmupFrames, int textCount, const std::string& fontName, bool distanceField = false);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_textCount;							///< Number of text objects.
+	std::string m_fontName;						///< Font file in the font folder.
+	bool m_distanceField;						///< True to draw distance field texts.
+	std::shared_ptr<Renderer> m_renderer;		///< Sprite renderer, or text renderer for distance fields.
+	std::vector<std::shared_ptr<Text>> m_texts;	///< The texts.
+	unsigned int m_step;						///< Steps run, used to build the strings.
+};
+
+/**
+ * @class TextLogScenario
+ * @brief Appends a line to a scrolling log every step, the log holding many lines.
+ */
+class TextLogScenario final : public BenchmarkScenario
+{
+public:
+	TextLogScenario(const std::string& name, int frameCount, int warmupFrames, int lineCount, const std::string& fontName);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_lineCount;							///< Lines in the log before the first step.
+	std::string m_fontName;						///< Font file in the font folder.
+	std::shared_ptr<Renderer> m_renderer;		///< Sprite renderer.
+	std::shared_ptr<TextView> m_view;			///< The log.
+	unsigned int m_step;						///< Steps run, used to build the lines.
+};
+
+/**
+ * @class SoundTriggerScenario
+ * @brief Plays many short sounds every step.
+ */
+class SoundTriggerScenario final : public BenchmarkScenario
+{
+public:
+	SoundTriggerScenario(const std::string& name, int frameCount, int warmupFrames, int triggersPerStep);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_triggersPerStep;	///< Sounds played each step.
+};
+
+/**
+ * @class AudioMixScenario
+ * @brief Mixes many looping voices with the null audio driver, no audio device needed.
+ *
+ * Each step mixes a frame worth of audio. Reports the real-time factor, seconds of audio
+ * mixed per second of CPU, and the cost of one buffer.
+ */
+class AudioMixScenario final : public BenchmarkScenario
+{
+public:
+	AudioMixScenario(const std::string& name, int frameCount, int warmupFrames, int voiceCount, unsigned int sampleRate, unsigned int bufferSize);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_voiceCount;				///< Voices playing.
+	unsigned int m_sampleRate;		///< Requested sample rate.
+	unsigned int m_bufferSize;		///< Requested samples per buffer.
+	bool m_replacedPlayer;			///< True once the game sound player was replaced.
+	std::vector<float> m_buffer;	///< Mix output.
+	double m_mixSeconds;			///< CPU time spent mixing in measured steps.
+	double m_audioSeconds;			///< Audio mixed in measured steps.
+	unsigned long long m_buffers;	///< Buffers mixed in measured steps.
+};
+
+/**
+ * @class ResourceStormScenario
+ * @brief Loads and frees textures and sounds every step.
+ *
+ * In async mode the textures go through LoadTextureAsync and are freed once uploaded.
+ */
+class ResourceStormScenario final : public BenchmarkScenario
+{
+public:
+	ResourceStormScenario(const std::string& name, int frameCount, int warmupFrames, int texturesPerStep, int soundsPerStep, bool async);
+
+protected:
+	bool Setup() override;
+	void Step(float deltaTime) override;
+	void Render() override;
+	void Teardown() override;
+
+private:
+	int m_texturesPerStep;						///< Textures loaded each step.
+	int m_soundsPerStep;						///< Sounds loaded each step.
+	bool m_async;								///< True to load the textures in the background.
+	std::vector<std::string> m_loadedTextures;	///< Textures loaded in the last step, or still streaming in async mode.
+	std::vector<std::string> m_loadedSounds;	///< Sounds loaded in the last step.
+	unsigned int m_step;						///< Steps run, used to rotate through the files.
+
+	/**
+	 * @brief Frees what the last step loaded.
+	 */
+	void FreeLoaded();
+};
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Game.h"
+#include "Logger.h"
+#include "BenchmarkAssets.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkScenarios.h"
+
+/**
+ * @brief Command line options of the benchmark.
+ */
+struct BenchmarkOptions
+{
+	int frames = 600;							///< Measured frames per scenario.
+	int warmupFrames = 30;						///< Frames run before measuring.
+	std::string outputPath = "benchmark.json";	///< Where the results are written.
+	std::string filter;							///< Only run scenarios whose name contains this.
+	std::string font;							///< Font used by the text scenario.
+	std::string root;							///< Folder containing Resources, the current one by default.
+	bool nullAudio = false;						///< True to mix sounds without an audio device.
+};
+
+static void PrintUsage()
+{
+	Log("Usage: Benchmark [--frames N] [--warmup N] [--out results.json] [--filter name] [--font file.ttf] [--root folder] [--null-audio]\n");
+}
+
+static bool ParseOptions(int argc, char** argv, BenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (!std::strcmp(arg, "--frames") && hasValue)
+		{
+			options.frames = std::max(std::atoi(argv[++i]), 1);
+		}
+		else if (!std::strcmp(arg, "--warmup") && hasValue)
+		{
+			options.warmupFrames = std::max(std::atoi(argv[++i]), 0);
+		}
+		else if (!std::strcmp(arg, "--out") && hasValue)
+		{
+			options.outputPath = argv[++i];
+		}
+		else if (!std::strcmp(arg, "--filter") && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (!std::strcmp(arg, "--font") && hasValue)
+		{
+			options.font = argv[++i];
+		}
+		else if (!std::strcmp(arg, "--root") && hasValue)
+		{
+			options.root = argv[++i];
+		}
+		else if (!std::strcmp(arg, "--null-audio"))
+		{
+			options.nullAudio = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static std::vector<std::shared_ptr<BenchmarkScenario>> CreateScenarios(const BenchmarkOptions& options)
+{
+	int frames = options.frames;
+	int warmup = options.warmupFrames;
+	std::string font = options.font.empty() ? BenchmarkAssets::FindFont() : options.font;
+
+	std::vector<std::shared_ptr<BenchmarkScenario>> all =
+	{
+		std::make_shared<SpriteScenario>("static_sprites_10k", frames, warmup, 10000, false),
+		std::make_shared<SpriteScenario>("static_sprites_100k", frames, warmup, 100000, false),
+		std::make_shared<SpriteScenario>("moving_sprites_10k", frames, warmup, 10000, true),
+		std::make_shared<SpriteScenario>("mixed_sprites_10k", frames, warmup, 10000, false, BenchmarkAssets::STORM_TEXTURE_COUNT, false),
+		std::make_shared<SpriteScenario>("atlas_sprites_10k", frames, warmup, 10000, false, BenchmarkAssets::STORM_TEXTURE_COUNT, true),
+		std::make_shared<AnimationScenario>("animated_sprites_1k", frames, warmup, 1000),
+		std::make_shared<TextChurnScenario>("text_churn_200", frames, warmup, 200, font),
+		std::make_shared<TextChurnScenario>("text_churn_sdf_200", frames, warmup, 200, font, true),
+		std::make_shared<TextLogScenario>("text_log_40", frames, warmup, 40, font),
+		std::make_shared<TextLogScenario>("text_log_100k", frames, warmup, 100000, font),
+		std::make_shared<SoundTriggerScenario>("sound_triggers_64", frames, warmup, 64),
+		std::make_shared<AudioMixScenario>("audio_mix_16", frames, warmup, 16, 48000, 512),
+		std::make_shared<AudioMixScenario>("audio_mix_64", frames, warmup, 64, 48000, 512),
+		std::make_shared<AudioMixScenario>("audio_mix_251", frames, warmup, 251, 48000, 512),
+		std::make_shared<AudioMixScenario>("audio_mix_64_44k_2048", frames, warmup, 64, 44100, 2048),
+		std::make_shared<ResourceStormScenario>("resource_storm", frames, warmup, 8, 2, false),
+		std::make_shared<ResourceStormScenario>("resource_storm_async", frames, warmup, 8, 2, true),
+	};
+
+	std::vector<std::shared_ptr<BenchmarkScenario>> selected;
+	for (const auto& scenario : all)
+	{
+		if (options.filter.empty() || scenario->GetName().find(options.filter) != std::string::npos)
+		{
+			selected.push_back(scenario);
+		}
+	}
+	return selected;
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (!options.root.empty())
+	{
+		std::error_code error;
+		std::filesystem::current_path(options.root, error);
+		if (error)
+		{
+			LogError("Can not change directory to %s", options.root.c_str());
+			return 1;
+		}
+	}
+
+	if (!BenchmarkAssets::Generate())
+	{
+		return 1;
+	}
+
+	auto scenarios = CreateScenarios(options);
+	if (scenarios.empty())
+	{
+		LogError("No scenario matches %s", options.filter.c_str());
+		return 1;
+	}
+
+	// one simulation step per frame with the same delta time every run
+	const float frameTime = 1.f / 60.f;
+	auto runner = std::make_shared<BenchmarkRunner>(scenarios, options.outputPath, frameTime);
+
+	Game::Construct();
+	GAME()->SetHeadless(true);
+	GAME()->SetFixedFrameTime(frameTime);
+	if (options.nullAudio)
+	{
+		SoundPlayerConfig soundConfig;
+		soundConfig.nullDriver = true;
+		GAME()->SetSoundConfig(soundConfig);
+	}
+	GAME()->SetInitialState(runner);
+	GAME()->Run();
+	Game::Destruct();
+
+	return runner->Succeeded() ? 0 : 1;
+}
@@ -7,6 +7,7 @@ uniform mat4 u_mvpMatrix;
 
 uniform float currentFrame;
 uniform float frameCount;
+uniform vec4 u_uvRect;  // Sheet rect in the bound texture (u0, v0, u1, v1)
 
 out vec2 v_texCoord;  // Output texture coordinate
 
@@ -20,5 +21,8 @@ void main()
     float frameX = mod(currentFrame, frameCount) * frameWidth;  
 
     // Assume texture coordinates lie within a single row of spritesheet
-    v_texCoord = vec2(frameX + frameWidth * texCoord.x, texCoord.y);
+    vec2 sheetCoord = vec2(frameX + frameWidth * texCoord.x, texCoord.y);
+
+    // Map into the sheet rect when the sheet lives in an atlas
+    v_texCoord = mix(u_uvRect.xy, u_uvRect.zw, sheetCoord);
 }
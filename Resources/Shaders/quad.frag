@@ -5,8 +5,9 @@ in vec2 varyingTexCoord;
 out vec4 fragColor;
 
 uniform sampler2D spriteTexture;
+uniform vec4 u_color;   // Tint, white for sprites and the text color for text
 
 void main()
 {
-    fragColor = texture(spriteTexture, varyingTexCoord);
+    fragColor = texture(spriteTexture, varyingTexCoord) * u_color;
 }
@@ -0,0 +1,19 @@
+#version 330 core 
+
+in vec2 varyingTexCoord;
+
+out vec4 fragColor;
+
+uniform sampler2D spriteTexture;
+uniform vec4 u_color;   // Text color
+
+void main()
+{
+    // alpha holds the distance to the glyph edge, 0.5 on the edge
+    float distance = texture(spriteTexture, varyingTexCoord).a;
+
+    // antialias over about one screen pixel whatever the scale
+    float smoothing = max(fwidth(distance) * 0.75, 1e-4);
+    float coverage = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    fragColor = vec4(u_color.rgb, u_color.a * coverage);
+}
@@ -0,0 +1,15 @@
+#version 330 core 
+
+layout (location = 0) in vec3 vertexPosition; 
+layout (location = 1) in vec2 texCoord;
+
+uniform mat4 u_mvpMatrix;
+uniform vec4 u_uvRect;  // Image rect in the bound texture (u0, v0, u1, v1)
+
+out vec2 varyingTexCoord;
+
+void main()
+{
+    varyingTexCoord = mix(u_uvRect.xy, u_uvRect.zw, texCoord);
+    gl_Position = u_mvpMatrix * vec4(vertexPosition , 1.0); 
+}
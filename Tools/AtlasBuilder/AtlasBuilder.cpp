@@ -0,0 +1,484 @@
+#include "AtlasBuilder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include "Logger.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+namespace fs = std::filesystem;
+
+static const int MIN_PAGE_SIZE = 32;
+
+static bool IsImageFile(const fs::path& path)
+{
+	std::string extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return extension == ".png" || extension == ".tga" || extension == ".bmp" || extension == ".jpg" || extension == ".jpeg";
+}
+
+AtlasBuilder::AtlasBuilder(const AtlasBuilderOptions& options) : m_options(options)
+{
+}
+
+bool AtlasBuilder::Build()
+{
+	if (!LoadImages())
+	{
+		return false;
+	}
+	FindSequences();
+	LoadSettings();
+	Trim();
+	if (!Pack())
+	{
+		return false;
+	}
+
+	fs::create_directories(m_options.outputDirectory);
+	if (!WritePages() || !WriteManifest())
+	{
+		return false;
+	}
+
+	LogSuccess("Packed %zu images and %zu animations into %zu pages", m_images.size(), m_sequences.size(), m_pages.size());
+	return true;
+}
+
+bool AtlasBuilder::LoadImages()
+{
+	std::error_code error;
+	std::vector<fs::path> files;
+	for (const auto& entry : fs::directory_iterator(m_options.inputDirectory, error))
+	{
+		if (entry.is_regular_file() && IsImageFile(entry.path()))
+		{
+			files.push_back(entry.path());
+		}
+	}
+	if (error)
+	{
+		LogError("Can not read folder %s", m_options.inputDirectory.c_str());
+		return false;
+	}
+	if (files.empty())
+	{
+		LogError("No images found in %s", m_options.inputDirectory.c_str());
+		return false;
+	}
+	std::sort(files.begin(), files.end());
+
+	for (const auto& file : files)
+	{
+		int width, height, channels;
+		unsigned char* pixels = stbi_load(file.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (!pixels)
+		{
+			LogError("Failed to load %s: %s", file.string().c_str(), stbi_failure_reason());
+			return false;
+		}
+
+		SourceImage image;
+		image.name = file.stem().string();
+		image.width = width;
+		image.height = height;
+		image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		image.pivotX = m_options.pivotX;
+		image.pivotY = m_options.pivotY;
+		m_images.push_back(std::move(image));
+		stbi_image_free(pixels);
+	}
+	return true;
+}
+
+void AtlasBuilder::LoadSettings()
+{
+	fs::path path = fs::path(m_options.inputDirectory) / "atlas.json";
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	nlohmann::json settings = nlohmann::json::parse(file, nullptr, false);
+	if (settings.is_discarded())
+	{
+		LogWarning("Ignoring %s, it is not valid JSON", path.string().c_str());
+		return;
+	}
+
+	// pivots apply to a frame, or to every frame of an animation
+	if (settings.contains("pivots") && settings["pivots"].is_object())
+	{
+		for (const auto& pivot : settings["pivots"].items())
+		{
+			if (!pivot.value().is_array() || pivot.value().size() != 2)
+			{
+				LogWarning("Ignoring pivot of %s, expected [x, y]", pivot.key().c_str());
+				continue;
+			}
+
+			std::vector<size_t> targets;
+			auto sequence = m_sequences.find(pivot.key());
+			if (sequence != m_sequences.end())
+			{
+				for (const auto& frame : sequence->second.frames)
+				{
+					targets.push_back(frame.second);
+				}
+			}
+			for (size_t i = 0; i < m_images.size(); i++)
+			{
+				if (m_images[i].name == pivot.key())
+				{
+					targets.push_back(i);
+				}
+			}
+
+			for (size_t target : targets)
+			{
+				m_images[target].pivotX = pivot.value()[0].get<float>();
+				m_images[target].pivotY = pivot.value()[1].get<float>();
+			}
+		}
+	}
+
+	if (settings.contains("frameTimes") && settings["frameTimes"].is_object())
+	{
+		for (const auto& frameTime : settings["frameTimes"].items())
+		{
+			auto sequence = m_sequences.find(frameTime.key());
+			if (sequence != m_sequences.end() && frameTime.value().is_number())
+			{
+				sequence->second.frameTime = frameTime.value().get<double>();
+			}
+		}
+	}
+}
+
+void AtlasBuilder::FindSequences()
+{
+	for (size_t i = 0; i < m_images.size(); i++)
+	{
+		// split "run_12" into "run" and 12
+		const std::string& name = m_images[i].name;
+		size_t digits = name.size();
+		while (digits > 0 && std::isdigit(static_cast<unsigned char>(name[digits - 1])))
+		{
+			digits--;
+		}
+		if (digits == name.size() || name.size() - digits > 9)
+		{
+			continue;
+		}
+
+		size_t prefix = digits;
+		while (prefix > 0 && (name[prefix - 1] == '_' || name[prefix - 1] == '-'))
+		{
+			prefix--;
+		}
+		if (prefix == 0)
+		{
+			continue;
+		}
+
+		Sequence& sequence = m_sequences[name.substr(0, prefix)];
+		sequence.frameTime = m_options.frameTime;
+		sequence.frames.push_back(std::make_pair(std::stoi(name.substr(digits)), i));
+	}
+
+	// a single numbered file is not an animation
+	for (auto it = m_sequences.begin(); it != m_sequences.end();)
+	{
+		if (it->second.frames.size() < 2)
+		{
+			it = m_sequences.erase(it);
+		}
+		else
+		{
+			std::sort(it->second.frames.begin(), it->second.frames.end());
+			++it;
+		}
+	}
+}
+
+void AtlasBuilder::Trim()
+{
+	for (auto& image : m_images)
+	{
+		image.trimX = 0;
+		image.trimY = 0;
+		image.trimWidth = image.width;
+		image.trimHeight = image.height;
+		if (!m_options.trim)
+		{
+			continue;
+		}
+
+		int left = image.width, top = image.height, right = -1, bottom = -1;
+		for (int y = 0; y < image.height; y++)
+		{
+			const unsigned char* row = &image.pixels[static_cast<size_t>(y) * image.width * 4];
+			for (int x = 0; x < image.width; x++)
+			{
+				if (row[x * 4 + 3] != 0)
+				{
+					left = std::min(left, x);
+					right = std::max(right, x);
+					top = std::min(top, y);
+					bottom = std::max(bottom, y);
+				}
+			}
+		}
+
+		if (right < 0)
+		{
+			// fully transparent, keep a single pixel
+			image.trimWidth = 1;
+			image.trimHeight = 1;
+			continue;
+		}
+		image.trimX = left;
+		image.trimY = top;
+		image.trimWidth = right - left + 1;
+		image.trimHeight = bottom - top + 1;
+	}
+
+	if (!m_options.trim)
+	{
+		return;
+	}
+
+	// frames of an animation share the union of their rects so they stay aligned
+	for (const auto& sequence : m_sequences)
+	{
+		const SourceImage& first = m_images[sequence.second.frames.front().second];
+		int left = first.width, top = first.height, right = 0, bottom = 0;
+		bool sameSize = true;
+		for (const auto& frame : sequence.second.frames)
+		{
+			const SourceImage& image = m_images[frame.second];
+			sameSize &= image.width == first.width && image.height == first.height;
+			left = std::min(left, image.trimX);
+			top = std::min(top, image.trimY);
+			right = std::max(right, image.trimX + image.trimWidth);
+			bottom = std::max(bottom, image.trimY + image.trimHeight);
+		}
+
+		if (!sameSize)
+		{
+			LogWarning("Frames of %s have different sizes, they are trimmed one by one", sequence.first.c_str());
+			continue;
+		}
+		for (const auto& frame : sequence.second.frames)
+		{
+			SourceImage& image = m_images[frame.second];
+			image.trimX = left;
+			image.trimY = top;
+			image.trimWidth = right - left;
+			image.trimHeight = bottom - top;
+		}
+	}
+}
+
+bool AtlasBuilder::Pack()
+{
+	int padding = m_options.padding;
+	int maxSize = m_options.maxPageSize;
+
+	std::vector<size_t> remaining;
+	for (size_t i = 0; i < m_images.size(); i++)
+	{
+		const SourceImage& image = m_images[i];
+		if (image.trimWidth + padding * 2 > maxSize || image.trimHeight + padding * 2 > maxSize)
+		{
+			LogError("%s (%dx%d) does not fit in a %d page", image.name.c_str(), image.trimWidth, image.trimHeight, maxSize);
+			return false;
+		}
+		remaining.push_back(i);
+	}
+
+	// page sizes to try, smallest first
+	std::vector<Page> sizes;
+	for (int width = MIN_PAGE_SIZE; width <= maxSize; width *= 2)
+	{
+		if (width / 2 >= MIN_PAGE_SIZE)
+		{
+			sizes.push_back({ width, width / 2 });
+		}
+		sizes.push_back({ width, width });
+	}
+
+	while (!remaining.empty())
+	{
+		std::vector<stbrp_rect> rects(remaining.size());
+		long long area = 0;
+		for (size_t i = 0; i < remaining.size(); i++)
+		{
+			const SourceImage& image = m_images[remaining[i]];
+			rects[i] = {};
+			rects[i].id = static_cast<int>(i);
+			rects[i].w = image.trimWidth + padding * 2;
+			rects[i].h = image.trimHeight + padding * 2;
+			area += static_cast<long long>(rects[i].w) * rects[i].h;
+		}
+
+		// the smallest page holding everything left, or a full page of the largest size
+		Page page = sizes.back();
+		for (const auto& size : sizes)
+		{
+			if (static_cast<long long>(size.width) * size.height < area)
+			{
+				continue;
+			}
+
+			std::vector<stbrp_node> nodes(size.width);
+			stbrp_context context;
+			stbrp_init_target(&context, size.width, size.height, nodes.data(), static_cast<int>(nodes.size()));
+			if (stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size())))
+			{
+				page = size;
+				break;
+			}
+		}
+
+		std::vector<stbrp_node> nodes(page.width);
+		stbrp_context context;
+		stbrp_init_target(&context, page.width, page.height, nodes.data(), static_cast<int>(nodes.size()));
+		stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
+
+		int pageIndex = static_cast<int>(m_pages.size());
+		std::vector<size_t> left;
+		for (size_t i = 0; i < rects.size(); i++)
+		{
+			SourceImage& image = m_images[remaining[i]];
+			if (rects[i].was_packed)
+			{
+				image.page = pageIndex;
+				image.x = rects[i].x + padding;
+				image.y = rects[i].y + padding;
+			}
+			else
+			{
+				left.push_back(remaining[i]);
+			}
+		}
+		m_pages.push_back(page);
+		remaining.swap(left);
+	}
+	return true;
+}
+
+bool AtlasBuilder::WritePages() const
+{
+	int padding = m_options.padding;
+	for (size_t pageIndex = 0; pageIndex < m_pages.size(); pageIndex++)
+	{
+		const Page& page = m_pages[pageIndex];
+		std::vector<unsigned char> pixels(static_cast<size_t>(page.width) * page.height * 4, 0);
+
+		for (const auto& image : m_images)
+		{
+			if (image.page != static_cast<int>(pageIndex))
+			{
+				continue;
+			}
+
+			// copy the kept rect and repeat its border pixels in the padding
+			for (int y = -padding; y < image.trimHeight + padding; y++)
+			{
+				int sourceY = image.trimY + std::min(std::max(y, 0), image.trimHeight - 1);
+				for (int x = -padding; x < image.trimWidth + padding; x++)
+				{
+					int sourceX = image.trimX + std::min(std::max(x, 0), image.trimWidth - 1);
+					const unsigned char* source = &image.pixels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4];
+					unsigned char* destination = &pixels[(static_cast<size_t>(image.y + y) * page.width + image.x + x) * 4];
+					std::copy(source, source + 4, destination);
+				}
+			}
+		}
+
+		// uncompressed 32 bit TGA, top row first, readable by stb_image
+		unsigned char header[18] = {};
+		header[2] = 2;
+		header[12] = static_cast<unsigned char>(page.width & 0xFF);
+		header[13] = static_cast<unsigned char>(page.width >> 8);
+		header[14] = static_cast<unsigned char>(page.height & 0xFF);
+		header[15] = static_cast<unsigned char>(page.height >> 8);
+		header[16] = 32;
+		header[17] = 0x28;
+		for (size_t i = 0; i < pixels.size(); i += 4)
+		{
+			std::swap(pixels[i], pixels[i + 2]);
+		}
+
+		fs::path path = fs::path(m_options.outputDirectory) / (m_options.name + "_" + std::to_string(pageIndex) + ".tga");
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			LogError("Can not write %s", path.string().c_str());
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+		LogInfo("Wrote %s (%dx%d)", path.string().c_str(), page.width, page.height);
+	}
+	return true;
+}
+
+bool AtlasBuilder::WriteManifest() const
+{
+	nlohmann::json manifest;
+	manifest["version"] = 1;
+
+	manifest["pages"] = nlohmann::json::array();
+	for (size_t i = 0; i < m_pages.size(); i++)
+	{
+		manifest["pages"].push_back({
+			{ "file", m_options.name + "_" + std::to_string(i) + ".tga" },
+			{ "width", m_pages[i].width },
+			{ "height", m_pages[i].height } });
+	}
+
+	manifest["frames"] = nlohmann::json::object();
+	for (const auto& image : m_images)
+	{
+		manifest["frames"][image.name] = {
+			{ "page", image.page },
+			{ "rect", { image.x, image.y, image.trimWidth, image.trimHeight } },
+			{ "source", { image.width, image.height } },
+			{ "offset", { image.trimX, image.trimY } },
+			{ "pivot", { image.pivotX, image.pivotY } } };
+	}
+
+	manifest["animations"] = nlohmann::json::object();
+	for (const auto& sequence : m_sequences)
+	{
+		nlohmann::json frames = nlohmann::json::array();
+		for (const auto& frame : sequence.second.frames)
+		{
+			frames.push_back(m_images[frame.second].name);
+		}
+		manifest["animations"][sequence.first] = {
+			{ "frames", frames },
+			{ "frameTime", sequence.second.frameTime } };
+	}
+
+	fs::path path = fs::path(m_options.outputDirectory) / (m_options.name + ".json");
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		LogError("Can not write %s", path.string().c_str());
+		return false;
+	}
+	file << manifest.dump(4);
+	LogInfo("Wrote %s", path.string().c_str());
+	return true;
+}
\ No newline at end of file
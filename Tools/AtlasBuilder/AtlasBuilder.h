@@ -0,0 +1,131 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Command line options of the atlas builder.
+ */
+struct AtlasBuilderOptions
+{
+	std::string inputDirectory;		///< Folder of source images.
+	std::string outputDirectory;	///< Folder receiving the pages and the manifest.
+	std::string name;				///< Base name of the manifest and the pages.
+	int maxPageSize = 2048;			///< Largest page, a power of two.
+	int padding = 2;				///< Pixels around each image, filled with its border pixels.
+	bool trim = true;				///< Crop the transparent borders of the images.
+	float frameTime = 0.1f;			///< Default time of an animation frame in seconds.
+	float pivotX = 0.5f;			///< Default pivot, relative to the untrimmed image.
+	float pivotY = 0.5f;			///< Default pivot, relative to the untrimmed image.
+};
+
+/**
+ * @class AtlasBuilder
+ * @brief Packs a folder of images into power of two atlas pages and writes a JSON manifest.
+ *
+ * Every image becomes a frame named after its file. Files ending with a number, like
+ * run_0.png and run_1.png, also form an animation named after the common prefix. Frames of
+ * an animation are trimmed to the same rect so they stay aligned when played.
+ *
+ * An optional atlas.json in the input folder overrides pivots and frame times:
+ * { "pivots": { "coin": [0.5, 1.0] }, "frameTimes": { "run": 0.08 } }
+ */
+class AtlasBuilder
+{
+public:
+	/**
+	 * @brief Constructs a builder.
+	 * @param options The options.
+	 */
+	explicit AtlasBuilder(const AtlasBuilderOptions& options);
+
+	/**
+	 * @brief Loads, trims and packs the images, then writes the pages and the manifest.
+	 * @return True on success.
+	 */
+	bool Build();
+
+private:
+	/**
+	 * @brief An image of the input folder.
+	 */
+	struct SourceImage
+	{
+		std::string name;					///< File name without extension.
+		std::vector<unsigned char> pixels;	///< RGBA pixels, top row first.
+		int width = 0;						///< Width of the image.
+		int height = 0;						///< Height of the image.
+		int trimX = 0;						///< Left of the kept rect.
+		int trimY = 0;						///< Top of the kept rect.
+		int trimWidth = 0;					///< Width of the kept rect.
+		int trimHeight = 0;					///< Height of the kept rect.
+		int page = -1;						///< Page the image is packed in.
+		int x = 0;							///< Left of the kept rect in the page.
+		int y = 0;							///< Top of the kept rect in the page.
+		float pivotX = 0.5f;				///< Pivot relative to the untrimmed image.
+		float pivotY = 0.5f;				///< Pivot relative to the untrimmed image.
+	};
+
+	/**
+	 * @brief Frames sharing a name prefix and ending with their index.
+	 */
+	struct Sequence
+	{
+		std::vector<std::pair<int, size_t>> frames;	///< Frame number and index of the image.
+		double frameTime = 0.1;						///< Time of a frame in seconds.
+	};
+
+	/**
+	 * @brief A packed page.
+	 */
+	struct Page
+	{
+		int width;	///< Width in pixels.
+		int height;	///< Height in pixels.
+	};
+
+	/**
+	 * @brief Loads every image of the input folder as RGBA.
+	 * @return False if the folder is empty or an image can not be read.
+	 */
+	bool LoadImages();
+
+	/**
+	 * @brief Groups numbered images into animations.
+	 */
+	void FindSequences();
+
+	/**
+	 * @brief Applies the pivots and frame times of atlas.json, if the input folder has one.
+	 */
+	void LoadSettings();
+
+	/**
+	 * @brief Finds the rect of each image without its transparent borders.
+	 */
+	void Trim();
+
+	/**
+	 * @brief Packs the images into as few and as small pages as possible.
+	 * @return False if an image is larger than the maximum page size.
+	 */
+	bool Pack();
+
+	/**
+	 * @brief Writes the pages as TGA files.
+	 * @return False if a file can not be written.
+	 */
+	bool WritePages() const;
+
+	/**
+	 * @brief Writes the JSON manifest describing the frames and animations.
+	 * @return False if the file can not be written.
+	 */
+	bool WriteManifest() const;
+
+	AtlasBuilderOptions m_options;				///< The options.
+	std::vector<SourceImage> m_images;			///< The images, sorted by name.
+	std::map<std::string, Sequence> m_sequences;	///< The animations by name.
+	std::vector<Page> m_pages;					///< The packed pages.
+};
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "AtlasBuilder.h"
+#include "Logger.h"
+
+static void PrintUsage()
+{
+	Log("Usage: AtlasBuilder <input folder> <output folder> <name> [--max-size N] [--padding N] [--no-trim] [--frame-time seconds] [--pivot x y]\n");
+}
+
+static bool IsPowerOfTwo(int value)
+{
+	return value > 0 && (value & (value - 1)) == 0;
+}
+
+static bool ParseOptions(int argc, char** argv, AtlasBuilderOptions& options)
+{
+	if (argc < 4)
+	{
+		return false;
+	}
+	options.inputDirectory = argv[1];
+	options.outputDirectory = argv[2];
+	options.name = argv[3];
+
+	for (int i = 4; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (!std::strcmp(arg, "--max-size") && hasValue)
+		{
+			options.maxPageSize = std::atoi(argv[++i]);
+			if (!IsPowerOfTwo(options.maxPageSize))
+			{
+				LogError("--max-size must be a power of two");
+				return false;
+			}
+		}
+		else if (!std::strcmp(arg, "--padding") && hasValue)
+		{
+			options.padding = std::max(std::atoi(argv[++i]), 0);
+		}
+		else if (!std::strcmp(arg, "--no-trim"))
+		{
+			options.trim = false;
+		}
+		else if (!std::strcmp(arg, "--frame-time") && hasValue)
+		{
+			options.frameTime = static_cast<float>(std::atof(argv[++i]));
+		}
+		else if (!std::strcmp(arg, "--pivot") && i + 2 < argc)
+		{
+			options.pivotX = static_cast<float>(std::atof(argv[++i]));
+			options.pivotY = static_cast<float>(std::atof(argv[++i]));
+		}
+		else
+		{
+			LogError("Unknown option %s", arg);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	AtlasBuilderOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	AtlasBuilder builder(options);
+	return builder.Build() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include "BaseObject.h"
 #include "IDGenerator.h"
+#include "Game.h"
+
+// marks an object whose transform has never been changed by a setter
+static constexpr unsigned long long NO_TRANSFORM_TICK = ~0ull;
 
 
 BaseObject::BaseObject(std::shared_ptr<Mesh> mesh, std::shared_ptr<Texture> texture) : 
@@ -12,6 +16,11 @@ BaseObject::BaseObject(std::shared_ptr<Mesh> mesh, std::shared_ptr<Texture> text
 	m_scale = glm::vec3(0.f, 0.f, 0.f);
 	m_worldMatrix = glm::mat4(1.f);
 	m_needCalculateWorldMatrix = true;
+	m_prevPosition = m_position;
+	m_prevRotationAngle = m_rotationAngle;
+	m_prevScale = m_scale;
+	m_transformTick = NO_TRANSFORM_TICK;
+	m_hasPrevTransform = false;
 }
 
 BaseObject::~BaseObject()
@@ -22,48 +31,60 @@ BaseObject::~BaseObject()
 
 void BaseObject::SetPosition(GLfloat x, GLfloat y, GLfloat z)
 {
+	SavePreviousTransform();
 	m_position = glm::vec3(x, y, z);
 	m_needCalculateWorldMatrix = true;
 }
 
 void BaseObject::SetPosition(const glm::vec3& position)
 {
+	SavePreviousTransform();
 	m_position = position;
 	m_needCalculateWorldMatrix = true;
 }
 
 void BaseObject::SetRotation(const glm::vec3& rotation)
 {
+	SavePreviousTransform();
 	m_rotationAngle = rotation;
 	m_needCalculateWorldMatrix = true;
 }
 
 void BaseObject::SetRotation(GLfloat z, GLfloat x, GLfloat y)
 {
+	SavePreviousTransform();
 	m_rotationAngle = glm::vec3(x, y, z);
 	m_needCalculateWorldMatrix = true;
 }
 
 void BaseObject::SetSize(const glm::vec3& scale)
 {
+	SavePreviousTransform();
 	m_scale = scale;
 	m_needCalculateWorldMatrix = true;
 }
 
 void BaseObject::SetSize(GLfloat x, GLfloat y, GLfloat z)
 {
+	SavePreviousTransform();
 	m_scale = glm::vec3(x, y, z);
 	m_needCalculateWorldMatrix = true;
 }
 
+static glm::mat4 ComposeWorldMatrix(const glm::vec3& position, const glm::vec3& rotationAngle, const glm::vec3& scale)
+{
+	glm::mat4 worldMatrix = glm::mat4(1.0f);
+	worldMatrix = glm::translate(worldMatrix, position);
+	worldMatrix = glm::rotate(worldMatrix, glm::radians(rotationAngle.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	worldMatrix = glm::rotate(worldMatrix, glm::radians(rotationAngle.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	worldMatrix = glm::rotate(worldMatrix, glm::radians(rotationAngle.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	worldMatrix = glm::scale(worldMatrix, scale);
+	return worldMatrix;
+}
+
 void BaseObject::RecalculateWorldMatrix()
 {
-	m_worldMatrix = glm::mat4(1.0f);
-	m_worldMatrix = glm::translate(m_worldMatrix, m_position);
-	m_worldMatrix = glm::rotate(m_worldMatrix, glm::radians(m_rotationAngle.x), glm::vec3(1.0f, 0.0f, 0.0f));
-	m_worldMatrix = glm::rotate(m_worldMatrix, glm::radians(m_rotationAngle.y), glm::vec3(0.0f, 1.0f, 0.0f));
-	m_worldMatrix = glm::rotate(m_worldMatrix, glm::radians(m_rotationAngle.z), glm::vec3(0.0f, 0.0f, 1.0f));
-	m_worldMatrix = glm::scale(m_worldMatrix, m_scale);
+	m_worldMatrix = ComposeWorldMatrix(m_position, m_rotationAngle, m_scale);
 	//glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), m_position);
 	//glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), m_scale);
 	//glm::mat4 rotationMatrixX = glm::rotate(glm::mat4(1.0f), glm::radians(m_rotationAngle.x), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -75,6 +96,50 @@ void BaseObject::RecalculateWorldMatrix()
 	m_needCalculateWorldMatrix = false;
 }
 
+glm::mat4 BaseObject::GetInterpolatedWorldMatrix(float alpha)
+{
+	if (m_needCalculateWorldMatrix)
+	{
+		RecalculateWorldMatrix();
+	}
+
+	if (!IsInterpolating() || alpha >= 1.f)
+	{
+		return m_worldMatrix;
+	}
+
+	return ComposeWorldMatrix(glm::mix(m_prevPosition, m_position, alpha),
+		glm::mix(m_prevRotationAngle, m_rotationAngle, alpha),
+		glm::mix(m_prevScale, m_scale, alpha));
+}
+
+bool BaseObject::IsInterpolating() const
+{
+	// only objects moved during the latest simulation step blend from their previous transform
+	return m_hasPrevTransform && m_transformTick == GAME()->GetSimulationTick();
+}
+
+void BaseObject::ResetInterpolation()
+{
+	m_hasPrevTransform = false;
+}
+
+void BaseObject::SavePreviousTransform()
+{
+	unsigned long long tick = GAME()->GetSimulationTick();
+	if (m_transformTick == tick)
+	{
+		return;
+	}
+
+	// first change in this step, what we have now is the state of the previous step
+	m_prevPosition = m_position;
+	m_prevRotationAngle = m_rotationAngle;
+	m_prevScale = m_scale;
+	m_hasPrevTransform = m_transformTick != NO_TRANSFORM_TICK;
+	m_transformTick = tick;
+}
+
 void BaseObject::SendUniformData(std::map<std::string, GLint>& uniformLocationData)
 {
 
@@ -107,4 +172,6 @@ GLuint BaseObject::GetID() const
 
 BaseObject::BaseObject()
 {
+	m_transformTick = NO_TRANSFORM_TICK;
+	m_hasPrevTransform = false;
 }
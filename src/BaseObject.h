@@ -75,6 +75,26 @@ public:
 	 */
 	void RecalculateWorldMatrix();
 
+	/**
+	 * @brief Gets the world matrix blended between the previous and the current simulation step.
+	 * @param alpha Interpolation factor (0 is the previous step, 1 is the current step).
+	 * @return The interpolated 4x4 world matrix.
+	 */
+	glm::mat4 GetInterpolatedWorldMatrix(float alpha);
+
+	/**
+	 * @brief Checks if the object was moved during the latest simulation step.
+	 * @return True if rendering should blend from the previous transform.
+	 */
+	bool IsInterpolating() const;
+
+	/**
+	 * @brief Makes the object snap to its current transform instead of blending from the previous one.
+	 *
+	 * Call this after teleporting an object so it does not visibly slide to the new place.
+	 */
+	void ResetInterpolation();
+
 	/**
 	 * @brief Sends uniform data to the shader.
 	 * @param uniformLocationData A map of uniform names to their location.
@@ -124,11 +144,23 @@ protected:
 	BaseObject();
 
 
+	/**
+	 * @brief Saves the current transform as the previous one, once per simulation step.
+	 *
+	 * Called by every transform setter before the new value is applied.
+	 */
+	void SavePreviousTransform();
+
 	int m_objectId;							///< The unique ID of the object.
 	glm::vec3 m_position;					///< The position of the object.
 	glm::vec3 m_rotationAngle;				///< The rotation angle of the object.
 	glm::vec3 m_scale;						///< The scale of the object.
 	glm::mat4 m_worldMatrix;				///< The world matrix of the object.
+	glm::vec3 m_prevPosition;				///< The position at the end of the previous simulation step.
+	glm::vec3 m_prevRotationAngle;			///< The rotation angle at the end of the previous simulation step.
+	glm::vec3 m_prevScale;					///< The scale at the end of the previous simulation step.
+	unsigned long long m_transformTick;		///< The simulation tick the previous transform was saved in.
+	bool m_hasPrevTransform;				///< Indicates if the previous transform is valid for interpolation.
 	std::shared_ptr<Mesh> m_mesh;			///< The mesh of the object.
 	std::shared_ptr<Texture> m_texture;		///< The texture of the object.
 	std::string m_objectType;				///< The string name of the object.
@@ -5,6 +5,12 @@
 #include "Shader.h"
 #include "Camera.h"
 #include "SpriteAnimation.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "Game.h"
+#include "Profiler.h"
+
+#include <algorithm>
 
 BatchRenderer::BatchRenderer()
 {
@@ -14,6 +20,8 @@ BatchRenderer::BatchRenderer()
 	m_maxVerticesCount = 0;
 	m_needRebuildBuffer = true;
 	m_needSendData = true;
+	m_hasInterpolatedObjects = false;
+	m_atlasLayoutVersion = TextureAtlas::GetLayoutVersion();
 }
 
 BatchRenderer::BatchRenderer(GLuint maxVerticesCount, const std::shared_ptr<Camera> camera, const std::shared_ptr<Shader> shader) :
@@ -44,6 +52,8 @@ BatchRenderer::BatchRenderer(GLuint maxVerticesCount, const std::shared_ptr<Came
 
 	m_needRebuildBuffer = true;
 	m_needSendData = true;
+	m_hasInterpolatedObjects = false;
+	m_atlasLayoutVersion = TextureAtlas::GetLayoutVersion();
 }
 
 BatchRenderer::~BatchRenderer()
@@ -85,6 +95,8 @@ void BatchRenderer::RemoveObject(GLuint id)
 
 void BatchRenderer::BuildBuffer()
 {
+	PROFILE_SCOPE("BatchRenderer::BuildBuffer");
+
 	if (!m_needRebuildBuffer)
 	{
 		return;
@@ -96,6 +108,7 @@ void BatchRenderer::BuildBuffer()
 	}
 
 	int vertexCount = 0;
+	float alpha = GAME()->GetInterpolationAlpha();
 	glm::mat4 viewMatrix = m_camera->GetViewMatrix();
 	glm::mat4 projectionMatrix = m_camera->GetProjectionMatrix();
 
@@ -103,7 +116,9 @@ void BatchRenderer::BuildBuffer()
 	m_vertexBuffer.clear();
 	m_indexBuffer.clear();
 
-	m_texture = m_RenderObjects.begin()->second->m_texture;
+	m_drawRanges.clear();
+	m_hasInterpolatedObjects = false;
+	m_atlasLayoutVersion = TextureAtlas::GetLayoutVersion();
 
 	for (const auto& obj : m_RenderObjects)
 	{
@@ -120,18 +135,29 @@ void BatchRenderer::BuildBuffer()
 			obj.second->RecalculateWorldMatrix();
 		}
 
-		// push indices to index buffer
+		// atlas images on the same page are drawn together,
+		// a new range starts whenever the bound texture changes
+		// a mesh split over several textures, such as a text, adds one run per texture
+		auto& texture = obj.second->m_texture;
+		std::shared_ptr<Texture> boundTexture = texture->GetAtlasPage() ? texture->GetAtlasPage() : texture;
 		auto& indicesData = obj.second->m_mesh->m_indices;
-		for (int i = 0; i < indicesData.size(); i++)
+		auto& meshRanges = obj.second->m_mesh->m_ranges;
+		if (meshRanges.empty())
+		{
+			PushIndices(boundTexture, vertexCount, indicesData, 0, indicesData.size());
+		}
+		for (const auto& range : meshRanges)
 		{
-			m_indexBuffer.push_back(vertexCount + indicesData[i]);
+			PushIndices(range.texture, vertexCount, indicesData, range.firstIndex, range.indexCount);
 		}
 
 		// push vertices to vertex buffer
 		auto& objVertexData = obj.second->m_mesh->m_vertices;
-		glm::mat4 objModelMat = obj.second->GetWorldMatrix();
+		m_hasInterpolatedObjects |= obj.second->IsInterpolating();
+		glm::mat4 objModelMat = obj.second->GetInterpolatedWorldMatrix(alpha);
 		glm::mat4 mvp;
 		Vertex tempVertex;
+		const glm::vec4& uvRect = texture->GetUVRect();
 		// calculate mvp matrix
 		mvp = projectionMatrix * viewMatrix * objModelMat;
 		for (int i = 0; i < objVertexData.size(); i++)
@@ -141,28 +167,31 @@ void BatchRenderer::BuildBuffer()
 			glm::vec4 vertexPosition = glm::vec4(tempVertex.position, 1.0f);
 			vertexPosition = mvp * vertexPosition;
 			tempVertex.position = glm::vec3(vertexPosition.x, vertexPosition.y, vertexPosition.z);
+			tempVertex.uv = glm::mix(glm::vec2(uvRect.x, uvRect.y), glm::vec2(uvRect.z, uvRect.w), tempVertex.uv);
 			m_vertexBuffer.push_back(tempVertex);
 			vertexCount++;
 		}
 	}
 	m_needRebuildBuffer = false;
+	m_needSendData = true;
 }
 
 void BatchRenderer::Render()
 {
-	bool doneCheckObj = false;
-#pragma omp parallel
+	PROFILE_SCOPE("BatchRenderer::Render");
+
+	// rebuild when an object moved, is blending between simulation steps
+	// or was still blending in the last build and has to settle on its final transform
+	if (!m_needRebuildBuffer)
 	{
-#pragma omp for
-		for (const auto& obj : m_RenderObjects)
-		{
-			if (obj.second->m_needCalculateWorldMatrix && !doneCheckObj)
+		m_needRebuildBuffer = m_hasInterpolatedObjects || std::any_of(m_RenderObjects.begin(), m_RenderObjects.end(),
+			[](const std::pair<const GLuint, std::shared_ptr<BaseObject>>& obj)
 			{
-				doneCheckObj = true;
-				m_needRebuildBuffer = true;
-				break;
-			}
-		}
+				return obj.second->m_needCalculateWorldMatrix || obj.second->IsInterpolating();
+			});
+
+		// baked UVs are stale once an atlas moved its images
+		m_needRebuildBuffer |= m_atlasLayoutVersion != TextureAtlas::GetLayoutVersion();
 	}
 
 	if (m_needRebuildBuffer)
@@ -190,10 +219,12 @@ void BatchRenderer::Render()
 		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(m_indexBuffer.size() * sizeof(GLuint)), m_indexBuffer.data());
 	}
 
-	// bind texture
-	m_texture->Bind();
-
-	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indexBuffer.size()), GL_UNSIGNED_INT, 0);
+	// one draw call per texture run
+	for (const auto& range : m_drawRanges)
+	{
+		range.texture->Bind();
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT, (void*)(range.firstIndex * sizeof(GLuint)));
+	}
 
 	glBindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -205,3 +236,18 @@ void BatchRenderer::PushVertex(const Vertex& vertex)
 {
 	m_vertexBuffer.push_back(vertex);
 }
+
+void BatchRenderer::PushIndices(const std::shared_ptr<Texture>& texture, int vertexOffset, const std::vector<GLuint>& indices, size_t firstIndex, size_t indexCount)
+{
+	if (m_drawRanges.empty() || m_drawRanges.back().texture != texture)
+	{
+		m_drawRanges.push_back({ texture, m_indexBuffer.size(), 0 });
+	}
+
+	// push indices to index buffer
+	for (size_t i = firstIndex; i < firstIndex + indexCount; i++)
+	{
+		m_indexBuffer.push_back(vertexOffset + indices[i]);
+	}
+	m_drawRanges.back().indexCount += indexCount;
+}
@@ -29,6 +29,9 @@ public:
 private:
 	void PushVertex(const Vertex& vertex);
 
+	// pushes indices of an object, in the last draw range when it has the same texture
+	void PushIndices(const std::shared_ptr<Texture>& texture, int vertexOffset, const std::vector<GLuint>& indices, size_t firstIndex, size_t indexCount);
+
 private:
 	// contains objects to be rendered. stored by pair id - object
 	std::map<GLuint, std::shared_ptr<BaseObject>> m_RenderObjects;
@@ -38,12 +41,22 @@ private:
 	std::vector<GLuint> m_indexBuffer;
 	std::vector<glm::mat4> m_uniformBuffer;
 
+	// a run of consecutive objects drawn with the same texture
+	struct DrawRange
+	{
+		std::shared_ptr<Texture> texture;
+		size_t firstIndex;
+		size_t indexCount;
+	};
+	std::vector<DrawRange> m_drawRanges;
+
 	std::shared_ptr<Camera> m_camera;
 	std::shared_ptr<Shader> m_shader;
-	std::shared_ptr<Texture> m_texture;
 	GLuint m_maxVerticesCount;
+	unsigned int m_atlasLayoutVersion;
 
 	GLuint m_VBO, m_IBO, m_VAO;
 	bool m_needRebuildBuffer;
 	bool m_needSendData;
+	bool m_hasInterpolatedObjects;
 };
\ No newline at end of file
@@ -11,4 +11,10 @@ namespace ResourcesPath
 	const std::string SHADER = "./Resources/Shaders/";
 	const std::string SOUND = "./Resources/Sounds/";
 	const std::string FONT = "./Resources/Fonts/";
+}
+
+namespace CachePath
+{
+	const std::string TEXTURE = "./Resources/Cache/Textures/";
+	const std::string SOUND = "./Resources/Cache/Sounds/";
 }
\ No newline at end of file
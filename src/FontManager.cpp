@@ -0,0 +1,116 @@
+#include "FontManager.h"
+
+#include "Config.h"
+#include "GlyphCache.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+FontManager::FontManager()
+{
+}
+
+FontManager::~FontManager()
+{
+}
+
+std::shared_ptr<TTF_Font> FontManager::Acquire(const std::string& name, int size)
+{
+	FontEntry& entry = m_fonts[{ name, size }];
+	std::shared_ptr<TTF_Font> font = entry.font.lock();
+	if (font)
+	{
+		return font;
+	}
+
+	PROFILE_SCOPE("FontManager::Acquire");
+
+	std::string path = ResourcesPath::FONT + name;
+	TTF_Font* rawFont = TTF_OpenFont(path.c_str(), size);
+	if (!rawFont)
+	{
+		LogError("Error loading font %s, %s", name.c_str(), TTF_GetError());
+		m_fonts.erase({ name, size });
+		return nullptr;
+	}
+
+	// the glyphs rasterized from the font go with it
+	font = std::shared_ptr<TTF_Font>(rawFont, [](TTF_Font* closedFont)
+		{
+			GlyphCache::Release(closedFont);
+			TTF_CloseFont(closedFont);
+		});
+	entry.font = font;
+	entry.metrics.height = TTF_FontHeight(rawFont);
+	entry.metrics.ascent = TTF_FontAscent(rawFont);
+	entry.metrics.descent = TTF_FontDescent(rawFont);
+	entry.metrics.lineSkip = TTF_FontLineSkip(rawFont);
+	return font;
+}
+
+bool FontManager::Load(const std::string& name, int size)
+{
+	std::shared_ptr<TTF_Font> font = Acquire(name, size);
+	if (!font)
+	{
+		return false;
+	}
+	m_fonts[{ name, size }].loaded = font;
+	return true;
+}
+
+TTF_Font* FontManager::Get(const std::string& name, int size) const
+{
+	auto it = m_fonts.find({ name, size });
+	if (it == m_fonts.end())
+	{
+		return nullptr;
+	}
+
+	// the holders keep the font alive past this temporary
+	return it->second.font.lock().get();
+}
+
+const FontMetrics* FontManager::GetMetrics(const std::string& name, int size) const
+{
+	auto it = m_fonts.find({ name, size });
+	if (it == m_fonts.end() || it->second.font.expired())
+	{
+		return nullptr;
+	}
+	return &it->second.metrics;
+}
+
+void FontManager::Free(const std::string& name, int size)
+{
+	for (auto it = m_fonts.begin(); it != m_fonts.end();)
+	{
+		if (it->first.name == name && (size == 0 || it->first.size == size))
+		{
+			it->second.loaded = nullptr;
+		}
+
+		if (it->second.font.expired())
+		{
+			it = m_fonts.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+void FontManager::Clear()
+{
+	m_fonts.clear();
+}
+
+size_t FontManager::GetOpenFontCount() const
+{
+	size_t count = 0;
+	for (const auto& it : m_fonts)
+	{
+		count += it.second.font.expired() ? 0 : 1;
+	}
+	return count;
+}
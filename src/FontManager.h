@@ -0,0 +1,130 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <SDL2/SDL_ttf.h>
+
+/**
+ * @brief Metrics of an open font, read once when it is opened.
+ */
+struct FontMetrics
+{
+	int height;		///< Height of a line of glyphs in pixels.
+	int ascent;		///< Distance from the top of a line to the baseline.
+	int descent;	///< Distance from the baseline to the bottom of a line, negative.
+	int lineSkip;	///< Distance between two baselines.
+};
+
+/**
+ * @class FontManager
+ * @brief Opens each font file once per size and shares it.
+ *
+ * Fonts are handed out as shared pointers: a font stays open while a Text or a Load holds it,
+ * and is closed with its glyph caches when the last holder lets go. Lookups are keyed by
+ * (name, size) in a hash map.
+ */
+class FontManager
+{
+public:
+	/**
+	 * @brief Constructs an empty manager.
+	 */
+	FontManager();
+
+	/**
+	 * @brief Destructor. Fonts still held by texts stay open until released.
+	 */
+	~FontManager();
+
+	/**
+	 * @brief Gets a font, opening it on first use.
+	 * @param name The font file in the font folder.
+	 * @param size The size in pt.
+	 * @return The font, or nullptr if it can not be opened.
+	 */
+	std::shared_ptr<TTF_Font> Acquire(const std::string& name, int size);
+
+	/**
+	 * @brief Opens a font and keeps it open until Free, even when no text uses it.
+	 * @param name The font file in the font folder.
+	 * @param size The size in pt.
+	 * @return True if the font is open.
+	 */
+	bool Load(const std::string& name, int size);
+
+	/**
+	 * @brief Gets an open font.
+	 * @param name The font file in the font folder.
+	 * @param size The size in pt.
+	 * @return The font, or nullptr if it is not open.
+	 */
+	TTF_Font* Get(const std::string& name, int size) const;
+
+	/**
+	 * @brief Gets the metrics of an open font.
+	 * @param name The font file in the font folder.
+	 * @param size The size in pt.
+	 * @return The metrics, or nullptr if the font is not open.
+	 */
+	const FontMetrics* GetMetrics(const std::string& name, int size) const;
+
+	/**
+	 * @brief Releases the fonts kept open by Load.
+	 * @param name The font file in the font folder.
+	 * @param size The size in pt, 0 for every size.
+	 *
+	 * A font still used by a text is closed when the text lets go of it.
+	 */
+	void Free(const std::string& name, int size = 0);
+
+	/**
+	 * @brief Releases every font kept open by Load and forgets all fonts.
+	 */
+	void Clear();
+
+	/**
+	 * @brief Gets the number of open fonts.
+	 * @return The number of fonts held by a text or a Load.
+	 */
+	size_t GetOpenFontCount() const;
+
+private:
+	/**
+	 * @brief A font file at a size.
+	 */
+	struct FontKey
+	{
+		std::string name;	///< The font file.
+		int size;			///< The size in pt.
+
+		bool operator==(const FontKey& other) const
+		{
+			return size == other.size && name == other.name;
+		}
+	};
+
+	/**
+	 * @brief Hash of a FontKey.
+	 */
+	struct FontKeyHash
+	{
+		size_t operator()(const FontKey& key) const
+		{
+			return std::hash<std::string>()(key.name) ^ (std::hash<int>()(key.size) * 31);
+		}
+	};
+
+	/**
+	 * @brief An open font.
+	 */
+	struct FontEntry
+	{
+		std::weak_ptr<TTF_Font> font;		///< The font, expired once closed.
+		std::shared_ptr<TTF_Font> loaded;	///< Reference held by Load, nullptr otherwise.
+		FontMetrics metrics;				///< Metrics read when opened.
+	};
+
+	std::unordered_map<FontKey, FontEntry, FontKeyHash> m_fonts;	///< Fonts by name and size.
+};
\ No newline at end of file
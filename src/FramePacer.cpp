@@ -0,0 +1,123 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <SDL2/SDL_timer.h>
+
+FramePacer::FramePacer()
+{
+	m_frameBudget = std::chrono::duration<float, std::micro>(0.f);
+	m_toleranceMicro = 200.f;
+	m_spinThresholdMicro = 2000.f;
+	m_minSpinThresholdMicro = 2000.f;
+	m_jitterMicro = 0.f;
+	m_maxJitterMicro = 0.f;
+	m_nextFrameTime = std::chrono::steady_clock::now();
+}
+
+void FramePacer::SetTargetFPS(float FPS)
+{
+	m_frameBudget = std::chrono::duration<float, std::micro>(FPS > 0.f ? 1000000.f / FPS : 0.f);
+	Reset();
+}
+
+void FramePacer::SetTolerance(float microseconds)
+{
+	m_toleranceMicro = std::max(microseconds, 0.f);
+}
+
+void FramePacer::SetSpinThreshold(float microseconds)
+{
+	m_minSpinThresholdMicro = std::max(microseconds, 0.f);
+	m_spinThresholdMicro = m_minSpinThresholdMicro;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	using Micro = std::chrono::duration<float, std::micro>;
+	auto now = std::chrono::steady_clock::now();
+
+	// sleep in whole milliseconds while we are outside of the spin window
+	// SDL sets the system timer resolution to 1ms on Windows, so SDL_Delay is accurate to about that
+	float remaining = Micro(m_nextFrameTime - now).count();
+	bool slept = false;
+	while (remaining > m_spinThresholdMicro + 1000.f)
+	{
+		SDL_Delay(static_cast<Uint32>((remaining - m_spinThresholdMicro) / 1000.f));
+		now = std::chrono::steady_clock::now();
+		remaining = Micro(m_nextFrameTime - now).count();
+		slept = true;
+	}
+
+	// how far past the deadline the last sleep woke, only meaningful if we slept
+	float overshoot = slept ? -remaining : 0.f;
+
+	// spin the last fraction for precision
+	while (now < m_nextFrameTime)
+	{
+		std::this_thread::yield();
+		now = std::chrono::steady_clock::now();
+	}
+
+	// track how far off the schedule this frame starts
+	float error = Micro(now - m_nextFrameTime).count();
+	m_jitterMicro += (std::fabs(error) - m_jitterMicro) * 0.1f;
+	m_maxJitterMicro = std::max(m_maxJitterMicro, error);
+
+	// a sleep that overshot the deadline widens the spin window, otherwise the time is slowly
+	// given back to sleeping; a frame that was late from its own work says nothing about sleeping
+	float budget = m_frameBudget.count();
+	if (overshoot > m_toleranceMicro)
+	{
+		m_spinThresholdMicro = std::min(m_spinThresholdMicro + overshoot, budget);
+	}
+	else
+	{
+		m_spinThresholdMicro = std::max(m_spinThresholdMicro * 0.995f, m_minSpinThresholdMicro);
+	}
+
+	// keep the cadence, unless a whole frame was missed then restart from now
+	auto frameBudget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_frameBudget);
+	if (now - m_nextFrameTime > frameBudget)
+	{
+		m_nextFrameTime = now + frameBudget;
+	}
+	else
+	{
+		m_nextFrameTime += frameBudget;
+	}
+}
+
+void FramePacer::Reset()
+{
+	m_nextFrameTime = std::chrono::steady_clock::now();
+	m_spinThresholdMicro = m_minSpinThresholdMicro;
+	m_jitterMicro = 0.f;
+	m_maxJitterMicro = 0.f;
+}
+
+bool FramePacer::IsEnabled() const
+{
+	return m_frameBudget.count() > 0.f;
+}
+
+float FramePacer::GetJitter() const
+{
+	return m_jitterMicro;
+}
+
+float FramePacer::GetMaxJitter() const
+{
+	return m_maxJitterMicro;
+}
+
+float FramePacer::GetSpinThreshold() const
+{
+	return m_spinThresholdMicro;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * @class FramePacer
+ * @brief Keeps a steady frame rate without burning a CPU core.
+ *
+ * The pacer sleeps for most of the time left in the frame budget and only spin-waits
+ * the last fraction of it, where the OS scheduler is not precise enough. The spin window
+ * adapts to the measured wake up error so the deadline is met within a configurable tolerance.
+ */
+class FramePacer
+{
+public:
+	/**
+	 * @brief Constructs a disabled FramePacer.
+	 */
+	FramePacer();
+
+	/**
+	 * @brief Sets the frame rate to pace to.
+	 * @param FPS The target frames per second (0 disables pacing).
+	 */
+	void SetTargetFPS(float FPS);
+
+	/**
+	 * @brief Sets the allowed scheduling error.
+	 * @param microseconds How late a frame may start before the spin window is widened.
+	 */
+	void SetTolerance(float microseconds);
+
+	/**
+	 * @brief Sets the time before the deadline where the pacer stops sleeping and starts spinning.
+	 * @param microseconds The initial spin window. It is adjusted at runtime within the frame budget.
+	 */
+	void SetSpinThreshold(float microseconds);
+
+	/**
+	 * @brief Blocks until the start of the next frame.
+	 *
+	 * Call once per frame. Returns immediately if pacing is disabled or the frame is already late.
+	 */
+	void WaitForNextFrame();
+
+	/**
+	 * @brief Restarts the frame schedule from now.
+	 */
+	void Reset();
+
+	/**
+	 * @brief Checks if the pacer is limiting the frame rate.
+	 * @return True if a target FPS is set.
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * @brief Gets the average error between the scheduled and the actual frame start.
+	 * @return The smoothed absolute error in microseconds.
+	 */
+	float GetJitter() const;
+
+	/**
+	 * @brief Gets the largest error between the scheduled and the actual frame start since the last reset.
+	 * @return The maximum error in microseconds.
+	 */
+	float GetMaxJitter() const;
+
+	/**
+	 * @brief Gets the current spin window.
+	 * @return The spin window in microseconds.
+	 */
+	float GetSpinThreshold() const;
+
+private:
+	std::chrono::steady_clock::time_point m_nextFrameTime;		///< Scheduled start of the next frame.
+	std::chrono::duration<float, std::micro> m_frameBudget;		///< Length of one frame.
+	float m_toleranceMicro;										///< Allowed scheduling error in microseconds.
+	float m_spinThresholdMicro;									///< Time spent spinning before the deadline in microseconds.
+	float m_minSpinThresholdMicro;								///< Lower bound the spin window shrinks back to.
+	float m_jitterMicro;										///< Smoothed absolute scheduling error in microseconds.
+	float m_maxJitterMicro;										///< Largest scheduling error in microseconds.
+};
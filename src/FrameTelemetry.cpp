@@ -0,0 +1,307 @@
+#include "FrameTelemetry.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+
+static const char* METRIC_NAMES[] = { "frame", "update", "draw", "swap" };
+
+FrameTelemetry::FrameTelemetry()
+{
+	for (auto& histogram : m_histograms)
+	{
+		histogram.assign(BUCKET_COUNT, 0);
+	}
+	m_windowHead = 0;
+	m_frameCount = 0;
+	m_stutterCount = 0;
+	m_windowSize = 3600;
+	m_frameBudgetMs = 1000.f / 60.f;
+	m_stutterFactor = 1.5f;
+	m_window.reserve(m_windowSize);
+}
+
+void FrameTelemetry::SetFrameBudget(float milliseconds)
+{
+	m_frameBudgetMs = milliseconds;
+}
+
+float FrameTelemetry::GetFrameBudget() const
+{
+	return m_frameBudgetMs;
+}
+
+void FrameTelemetry::SetStutterFactor(float factor)
+{
+	m_stutterFactor = factor;
+}
+
+void FrameTelemetry::SetWindowSize(size_t frameCount)
+{
+	// keep the most recent frames, oldest first, and rebuild the histograms from them
+	size_t windowSize = std::max<size_t>(frameCount, 1);
+	size_t count = std::min(GetWindowCount(), windowSize);
+	std::vector<FrameSample> window;
+	window.reserve(windowSize);
+	for (size_t i = GetWindowCount() - count; i < GetWindowCount(); i++)
+	{
+		window.push_back(GetWindowSample(i));
+	}
+	m_window.swap(window);
+	m_windowHead = 0;
+	m_windowSize = windowSize;
+
+	for (auto& histogram : m_histograms)
+	{
+		std::fill(histogram.begin(), histogram.end(), 0);
+	}
+	for (const auto& sample : m_window)
+	{
+		UpdateHistograms(sample, true);
+	}
+}
+
+void FrameTelemetry::SetCsvPath(const std::string& filePath)
+{
+	if (m_csvFile.is_open())
+	{
+		m_csvFile.close();
+		LogInfo("Frame telemetry written to %s", m_csvPath.c_str());
+	}
+	m_csvPath = filePath;
+	if (m_csvPath.empty())
+	{
+		return;
+	}
+
+	m_csvFile.open(m_csvPath);
+	if (!m_csvFile.is_open())
+	{
+		LogError("Failed to write frame telemetry to %s", m_csvPath.c_str());
+		return;
+	}
+	m_csvFile << "frame,frame_ms,update_ms,draw_ms,swap_ms,stutter\n";
+}
+
+void FrameTelemetry::RecordFrame(float frameMs, float updateMs, float drawMs, float swapMs)
+{
+	FrameSample sample;
+	sample.frameIndex = m_frameCount++;
+	sample.frameMs = frameMs;
+	sample.updateMs = updateMs;
+	sample.drawMs = drawMs;
+	sample.swapMs = swapMs;
+	sample.stutter = m_frameBudgetMs > 0.f && frameMs > m_frameBudgetMs * m_stutterFactor;
+
+	// slide the window, the oldest frame is overwritten once it is full
+	if (m_window.size() < m_windowSize)
+	{
+		m_window.push_back(sample);
+	}
+	else
+	{
+		UpdateHistograms(m_window[m_windowHead], false);
+		m_window[m_windowHead] = sample;
+		m_windowHead = (m_windowHead + 1) % m_window.size();
+	}
+	UpdateHistograms(sample, true);
+
+	if (m_csvFile.is_open())
+	{
+		WriteRow(m_csvFile, sample);
+	}
+
+	if (sample.stutter)
+	{
+		m_stutterCount++;
+		m_stutters.push_back(sample);
+		if (m_stutters.size() > MAX_STUTTERS)
+		{
+			m_stutters.pop_front();
+		}
+
+		// anything not covered by update, draw and swap is event handling, pacing or the OS
+		float otherMs = std::max(frameMs - updateMs - drawMs - swapMs, 0.f);
+		LogWarning("Stutter at frame %llu: %.2f ms (budget %.2f ms) update %.2f ms, draw %.2f ms, swap %.2f ms, other %.2f ms",
+			sample.frameIndex, frameMs, m_frameBudgetMs, updateMs, drawMs, swapMs, otherMs);
+	}
+}
+
+float FrameTelemetry::GetPercentile(Metric metric, float percentile) const
+{
+	size_t count = GetWindowCount();
+	if (count == 0)
+	{
+		return 0.f;
+	}
+
+	// walk the histogram until the requested rank is reached
+	const auto& histogram = m_histograms[(int)metric];
+	size_t rank = static_cast<size_t>(std::clamp(percentile, 0.f, 100.f) / 100.f * (count - 1)) + 1;
+	size_t seen = 0;
+	for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+	{
+		seen += histogram[bucket];
+		if (seen >= rank)
+		{
+			// report the upper edge of the bucket, but never more than the actual maximum
+			float maxValue = GetMax(metric);
+			return bucket == BUCKET_COUNT - 1 ? maxValue : std::min((bucket + 1) * BUCKET_MS, maxValue);
+		}
+	}
+	return GetMax(metric);
+}
+
+float FrameTelemetry::GetMax(Metric metric) const
+{
+	float maxValue = 0.f;
+	for (const auto& sample : m_window)
+	{
+		maxValue = std::max(maxValue, GetValue(sample, metric));
+	}
+	return maxValue;
+}
+
+float FrameTelemetry::GetOnePercentLowFPS() const
+{
+	size_t count = GetWindowCount();
+	if (count == 0)
+	{
+		return 0.f;
+	}
+
+	// average frame time of the slowest 1% of the window
+	std::vector<float> frameTimes;
+	frameTimes.reserve(count);
+	for (const auto& sample : m_window)
+	{
+		frameTimes.push_back(sample.frameMs);
+	}
+	size_t slowCount = std::max<size_t>(count / 100, 1);
+	std::nth_element(frameTimes.begin(), frameTimes.begin() + (slowCount - 1), frameTimes.end(), std::greater<float>());
+
+	float total = 0.f;
+	for (size_t i = 0; i < slowCount; i++)
+	{
+		total += frameTimes[i];
+	}
+	float average = total / slowCount;
+	return average > 0.f ? 1000.f / average : 0.f;
+}
+
+const FrameSample* FrameTelemetry::GetLastSample() const
+{
+	if (m_window.empty())
+	{
+		return nullptr;
+	}
+	return &GetWindowSample(GetWindowCount() - 1);
+}
+
+unsigned long long FrameTelemetry::GetFrameCount() const
+{
+	return m_frameCount;
+}
+
+const std::deque<FrameSample>& FrameTelemetry::GetStutters() const
+{
+	return m_stutters;
+}
+
+size_t FrameTelemetry::GetStutterCount() const
+{
+	return m_stutterCount;
+}
+
+void FrameTelemetry::LogSummary() const
+{
+	if (m_window.empty())
+	{
+		return;
+	}
+
+	LogInfo("Frame telemetry over the last %zu frames (%llu in session):", GetWindowCount(), m_frameCount);
+	for (int metric = 0; metric < (int)Metric::COUNT; metric++)
+	{
+		Metric m = static_cast<Metric>(metric);
+		LogInfo("  %-6s p50 %6.2f ms  p95 %6.2f ms  p99 %6.2f ms  max %6.2f ms", METRIC_NAMES[metric],
+			GetPercentile(m, 50.f), GetPercentile(m, 95.f), GetPercentile(m, 99.f), GetMax(m));
+	}
+	LogInfo("  1%% low %.1f FPS, %zu stutters over %.2f ms", GetOnePercentLowFPS(), m_stutterCount, m_frameBudgetMs * m_stutterFactor);
+}
+
+bool FrameTelemetry::WriteCSV(const std::string& filePath) const
+{
+	std::ofstream file(filePath);
+	if (!file.is_open())
+	{
+		LogError("Failed to write frame telemetry to %s", filePath.c_str());
+		return false;
+	}
+
+	file << "frame,frame_ms,update_ms,draw_ms,swap_ms,stutter\n";
+	for (size_t i = 0; i < GetWindowCount(); i++)
+	{
+		WriteRow(file, GetWindowSample(i));
+	}
+
+	LogInfo("Frame telemetry written to %s", filePath.c_str());
+	return true;
+}
+
+void FrameTelemetry::Dump()
+{
+	LogSummary();
+	SetCsvPath("");
+}
+
+float FrameTelemetry::GetValue(const FrameSample& sample, Metric metric)
+{
+	switch (metric)
+	{
+	case Metric::FRAME:
+		return sample.frameMs;
+	case Metric::UPDATE:
+		return sample.updateMs;
+	case Metric::DRAW:
+		return sample.drawMs;
+	case Metric::SWAP:
+		return sample.swapMs;
+	default:
+		return 0.f;
+	}
+}
+
+void FrameTelemetry::UpdateHistograms(const FrameSample& sample, bool add)
+{
+	for (int metric = 0; metric < (int)Metric::COUNT; metric++)
+	{
+		float value = std::max(GetValue(sample, static_cast<Metric>(metric)), 0.f);
+		size_t bucket = std::min(static_cast<size_t>(value / BUCKET_MS), BUCKET_COUNT - 1);
+		if (add)
+		{
+			m_histograms[metric][bucket]++;
+		}
+		else
+		{
+			m_histograms[metric][bucket]--;
+		}
+	}
+}
+
+size_t FrameTelemetry::GetWindowCount() const
+{
+	return m_window.size();
+}
+
+const FrameSample& FrameTelemetry::GetWindowSample(size_t index) const
+{
+	// the head is the oldest frame, it stays at 0 until the window is full
+	return m_window[(m_windowHead + index) % m_window.size()];
+}
+
+void FrameTelemetry::WriteRow(std::ostream& stream, const FrameSample& sample)
+{
+	stream << sample.frameIndex << ',' << sample.frameMs << ',' << sample.updateMs << ','
+		<< sample.drawMs << ',' << sample.swapMs << ',' << (sample.stutter ? 1 : 0) << '\n';
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct FrameSample
+ * @brief Timings of one frame in milliseconds.
+ */
+struct FrameSample
+{
+	unsigned long long frameIndex;	///< Index of the frame since the game started.
+	float frameMs;					///< Time between the start of this frame and the previous one.
+	float updateMs;					///< Time spent in the simulation steps of the frame.
+	float drawMs;					///< Time spent drawing the game and ImGui.
+	float swapMs;					///< Time spent in the buffer swap (includes waiting for VSync).
+	bool stutter;					///< True if the frame went over the stutter threshold.
+};
+
+/**
+ * @class FrameTelemetry
+ * @brief Records frame timings and reports percentiles and stutters.
+ *
+ * The last samples are kept in rolling histograms to report p50/p95/p99 values cheaply.
+ * Frames over the budget are flagged as stutters with the time spent in each subsystem.
+ * Only the window is kept in memory, the whole session can be streamed to a CSV file to compare builds.
+ */
+class FrameTelemetry
+{
+public:
+	/**
+	 * @enum Metric
+	 * @brief The timings tracked for each frame.
+	 */
+	enum class Metric
+	{
+		FRAME,
+		UPDATE,
+		DRAW,
+		SWAP,
+		COUNT
+	};
+
+	/**
+	 * @brief Constructs the telemetry with a 60 FPS budget and a 3600 frame window.
+	 */
+	FrameTelemetry();
+
+	/**
+	 * @brief Sets the expected frame time, normally the refresh interval or the FPS limit.
+	 * @param milliseconds The frame budget.
+	 */
+	void SetFrameBudget(float milliseconds);
+
+	/**
+	 * @brief Gets the frame budget.
+	 * @return The frame budget in milliseconds.
+	 */
+	float GetFrameBudget() const;
+
+	/**
+	 * @brief Sets how far over the budget a frame can go before it counts as a stutter.
+	 * @param factor Multiplier of the frame budget, 1.5 by default so VSync jitter is ignored.
+	 */
+	void SetStutterFactor(float factor);
+
+	/**
+	 * @brief Sets the number of recent frames kept and used for the percentiles.
+	 * @param frameCount The window size in frames.
+	 */
+	void SetWindowSize(size_t frameCount);
+
+	/**
+	 * @brief Opens a CSV file the frames are written to as they are recorded. No file is written by default.
+	 * @param filePath Path of the CSV file, empty to close the current one.
+	 */
+	void SetCsvPath(const std::string& filePath);
+
+	/**
+	 * @brief Records the timings of a frame.
+	 * @param frameMs Time between this frame and the previous one.
+	 * @param updateMs Time spent updating the game.
+	 * @param drawMs Time spent drawing.
+	 * @param swapMs Time spent swapping the buffers.
+	 */
+	void RecordFrame(float frameMs, float updateMs, float drawMs, float swapMs);
+
+	/**
+	 * @brief Gets a percentile of a metric over the rolling window.
+	 * @param metric The timing to query.
+	 * @param percentile The percentile in range [0, 100].
+	 * @return The value in milliseconds (0.1 ms precision).
+	 */
+	float GetPercentile(Metric metric, float percentile) const;
+
+	/**
+	 * @brief Gets the largest value of a metric over the rolling window.
+	 * @param metric The timing to query.
+	 * @return The value in milliseconds.
+	 */
+	float GetMax(Metric metric) const;
+
+	/**
+	 * @brief Gets the average FPS of the slowest 1% of the frames in the rolling window.
+	 * @return The 1% low FPS.
+	 */
+	float GetOnePercentLowFPS() const;
+
+	/**
+	 * @brief Gets the most recent frame.
+	 * @return The sample, nullptr before the first frame.
+	 */
+	const FrameSample* GetLastSample() const;
+
+	/**
+	 * @brief Gets the number of frames recorded in the session.
+	 * @return The frame count.
+	 */
+	unsigned long long GetFrameCount() const;
+
+	/**
+	 * @brief Gets the most recent stutters.
+	 * @return The stutters, oldest first.
+	 */
+	const std::deque<FrameSample>& GetStutters() const;
+
+	/**
+	 * @brief Gets the number of stutters in the session.
+	 * @return The stutter count.
+	 */
+	size_t GetStutterCount() const;
+
+	/**
+	 * @brief Logs percentiles and the stutter count for every metric.
+	 */
+	void LogSummary() const;
+
+	/**
+	 * @brief Writes the frames of the rolling window as CSV.
+	 * @param filePath Path of the file to write.
+	 * @return True if the file was written.
+	 */
+	bool WriteCSV(const std::string& filePath) const;
+
+	/**
+	 * @brief Logs the summary and closes the CSV file. Called by Game on exit.
+	 */
+	void Dump();
+
+private:
+	static constexpr float BUCKET_MS = 0.1f;		///< Width of a histogram bucket.
+	static constexpr size_t BUCKET_COUNT = 2501;	///< Buckets up to 250 ms, the last one collects everything above.
+	static constexpr size_t MAX_STUTTERS = 256;		///< Number of stutters kept for inspection.
+
+	std::vector<FrameSample> m_window;								///< Ring buffer of the frames in the rolling window.
+	size_t m_windowHead;											///< Index of the oldest frame once the window is full.
+	unsigned long long m_frameCount;								///< Frames in the session.
+	std::vector<unsigned int> m_histograms[(int)Metric::COUNT];		///< Rolling histogram for each metric.
+	std::deque<FrameSample> m_stutters;								///< Most recent stutters, MAX_STUTTERS at most.
+	size_t m_stutterCount;											///< Stutters in the session.
+	size_t m_windowSize;											///< Number of frames in the rolling window.
+	float m_frameBudgetMs;											///< Expected frame time.
+	float m_stutterFactor;											///< Multiplier of the budget above which a frame is a stutter.
+	std::string m_csvPath;											///< Path of the open CSV file.
+	std::ofstream m_csvFile;										///< The frames are written here as they are recorded.
+
+	/**
+	 * @brief Gets the value of a metric from a sample.
+	 */
+	static float GetValue(const FrameSample& sample, Metric metric);
+
+	/**
+	 * @brief Adds or removes a sample from the rolling histograms.
+	 * @param sample The sample.
+	 * @param add True to add, false to remove.
+	 */
+	void UpdateHistograms(const FrameSample& sample, bool add);
+
+	/**
+	 * @brief Gets the number of samples currently in the rolling window.
+	 */
+	size_t GetWindowCount() const;
+
+	/**
+	 * @brief Gets a sample of the rolling window.
+	 * @param index The index of the sample, 0 for the oldest.
+	 */
+	const FrameSample& GetWindowSample(size_t index) const;
+
+	/**
+	 * @brief Writes a sample as a CSV row.
+	 */
+	static void WriteRow(std::ostream& stream, const FrameSample& sample);
+};
\ No newline at end of file
@@ -30,7 +30,7 @@ void GSIntro::Update(float deltaTime)
 
 }
 
-void GSIntro::Draw()
+void GSIntro::Draw(float alpha)
 {
 
 }
@@ -22,7 +22,7 @@ public:
 
 	void Init() override;
 	void Update(float deltaTime) override;
-	void Draw() override;
+	void Draw(float alpha) override;
 	void Pause() override;
 	void Resume() override;
 	void Exit() override;
@@ -30,7 +30,7 @@ void GSMenu::Update(float deltaTime)
 
 }
 
-void GSMenu::Draw()
+void GSMenu::Draw(float alpha)
 {
 
 }
@@ -12,7 +12,7 @@ void GSPlay::Update(float deltaTime)
 {
 }
 
-void GSPlay::Draw()
+void GSPlay::Draw(float alpha)
 {
 }
 
@@ -12,7 +12,7 @@ void GSTemplate::Update(float deltaTime)
 {
 }
 
-void GSTemplate::Draw()
+void GSTemplate::Draw(float alpha)
 {
 }
 
@@ -5,6 +5,7 @@
 #endif // _WIN64 || _WIN32 
 
 #include <glad/glad.h>
+#include <cmath>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
 
@@ -12,6 +13,8 @@
 #include "GameStateMachine.h"
 #include "ResourceManager.h"
 #include "SoundPlayer.h"
+#include "Text.h"
+#include "Profiler.h"
 #include <imgui.h>
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_opengl3.h>
@@ -69,7 +72,8 @@ int Game::InitSDL()
 int Game::InitOpenGL()
 {
     // Create an SDL window
-    m_pWindow = SDL_CreateWindow("SDL OpenGL", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 960, 540, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
+    Uint32 windowFlags = SDL_WINDOW_OPENGL | (m_headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
+    m_pWindow = SDL_CreateWindow("SDL OpenGL", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 960, 540, windowFlags);
     if (!m_pWindow)
     {
         LogError("Failed to create SDL window, %s", SDL_GetError());
@@ -123,10 +127,17 @@ int Game::GameInit()
     SetClearColor();
 
     // default FPS limit is screen refresh rate
-    m_LimitFPS = 0.f;
+    SetFPSLimit(0.f);
 
-    // enable VSync by default
-    SetVSync(1);
+    // simulate at a fixed 60 ticks per second by default
+    SetTickRate(60.f);
+    m_maxStepsPerFrame = 5;
+    m_accumulator = 0.f;
+    m_interpolationAlpha = 1.f;
+    m_simulationTick = 0;
+
+    // enable VSync by default, a headless run goes as fast as it can
+    SetVSync(m_headless ? 0 : 1);
 
     // ignore Windows scaling
     SetIgnoreWindowsScaling();
@@ -141,25 +152,45 @@ int Game::GameInit()
 
     m_GameRunning = true;
 
+    // start the job workers before anything can schedule work
+    m_jobSystem.Init();
+
     // init singleton classes
+    Profiler::Construct();
+    m_showProfiler = false;
     ResourceManager::Construct();
     GameStateMachine::Construct();
     SoundPlayer::Construct();
-    SoundPlayer::GetInstance()->Init();
+    SoundPlayer::GetInstance()->Init(m_soundConfig);
     GameStateMachine::GetInstance()->Init();
 
     RESOURCE()->LoadMesh("quad.nfg");
     RESOURCE()->LoadMesh("quad_center.nfg");
     RESOURCE()->LoadShader("quad");
     RESOURCE()->LoadShader("animation");
+    RESOURCE()->LoadShader("text_sdf");
 
-    GSM()->PushState(GameStateType::STATE_INTRO);
+    if (m_initialState)
+    {
+        GSM()->PushState(m_initialState);
+        m_initialState = nullptr;
+    }
+    else
+    {
+        GSM()->PushState(GameStateType::STATE_INTRO);
+    }
 
     return 0;
 }
 
 void Game::CleanUp()
 {
+    // finish pending jobs while the resources they use are still alive
+    m_jobSystem.Shutdown();
+
+    // report the frame timings of the session
+    m_telemetry.Dump();
+
     // Destroy the OpenGL context and window
     if (m_GLContext)
     {
@@ -177,6 +208,7 @@ void Game::CleanUp()
     ResourceManager::Destruct();
     SOUNDPLAYER()->Deinit();
     SoundPlayer::Destruct();
+    Profiler::Destruct();
 
     // ImGUI quit
     ImGui_ImplOpenGL3_Shutdown();
@@ -204,20 +236,23 @@ void Game::Run()
         return;
     }
 
+    bool firstFrame = true;
     while (m_GameRunning)
     {
+        // Limit the FPS, sleeps until the next frame is due
+        if (m_LimitFPS)
+        {
+            m_framePacer.WaitForNextFrame();
+        }
+
+        PROFILER()->BeginFrame();
+
         HandleEvent(m_event);
         m_currentTime = std::chrono::steady_clock::now();
         m_durationMicro = m_currentTime - m_lastTime;
 
-        // Limit the FPS
-        if (m_LimitFPS && m_durationMicro.count() <= 1000000.f / m_LimitFPS)
-        {
-            continue;
-        }
-
         // calculate time between frame
-        m_deltaTime = m_durationMicro.count() / 1000000.f;
+        m_deltaTime = m_fixedFrameTime > 0.f ? m_fixedFrameTime : m_durationMicro.count() / 1000000.f;
         m_lastTime = m_currentTime;
 
         // Start the Dear ImGui frame
@@ -231,21 +266,85 @@ void Game::Run()
             GSM()->GetCurrentState()->ImGuiDraw();
         }
 
+        // engine debug overlays
+        if (m_showProfiler)
+        {
+            PROFILER()->DrawImGui(&m_showProfiler);
+        }
+
         // update the game
-        Update(m_deltaTime);
+        auto updateStart = std::chrono::steady_clock::now();
+        if (m_fixedDeltaTime > 0.f)
+        {
+            // step the simulation with a fixed delta time, the remainder is carried over to the next frame
+            m_accumulator += m_deltaTime;
+            int steps = 0;
+            while (m_accumulator >= m_fixedDeltaTime && steps < m_maxStepsPerFrame)
+            {
+                m_simulationTick++;
+                Update(m_fixedDeltaTime);
+                m_accumulator -= m_fixedDeltaTime;
+                steps++;
+            }
+
+            // too far behind, drop the time we can not catch up on
+            if (m_accumulator >= m_fixedDeltaTime)
+            {
+                m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+            }
+            m_interpolationAlpha = m_accumulator / m_fixedDeltaTime;
+        }
+        else
+        {
+            m_simulationTick++;
+            Update(m_deltaTime);
+            m_interpolationAlpha = 1.f;
+        }
+
+        // forget the sounds that finished playing
+        SOUNDPLAYER()->Update();
 
         // render
+        auto drawStart = std::chrono::steady_clock::now();
+
+        // stream in textures loaded in the background
+        RESOURCE()->Update();
+
+        // rebuild the texts changed this frame
+        Text::UpdateDirtyTexts();
+
         glClear(GL_COLOR_BUFFER_BIT);
 
         // game draw
-        Draw();
+        Draw(m_interpolationAlpha);
 
         // ImGui render
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            PROFILE_SCOPE("ImGui::Render");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // display on screen
-        SDL_GL_SwapWindow(m_pWindow);
+        auto swapStart = std::chrono::steady_clock::now();
+        {
+            PROFILE_SCOPE("SDL_GL_SwapWindow");
+            SDL_GL_SwapWindow(m_pWindow);
+        }
+
+        auto swapEnd = std::chrono::steady_clock::now();
+
+        PROFILER()->EndFrame();
+
+        // the first frame includes the loading time, do not count it
+        if (!firstFrame)
+        {
+            std::chrono::duration<float, std::milli> updateTime = drawStart - updateStart;
+            std::chrono::duration<float, std::milli> drawTime = swapStart - drawStart;
+            std::chrono::duration<float, std::milli> swapTime = swapEnd - swapStart;
+            m_telemetry.RecordFrame(m_durationMicro.count() / 1000.f, updateTime.count(), drawTime.count(), swapTime.count());
+        }
+        firstFrame = false;
 
         m_GameRunning = GSM()->IsRunning();
     }
@@ -255,6 +354,8 @@ void Game::Run()
 
 void Game::HandleEvent(SDL_Event& e)
 {
+    PROFILE_SCOPE("Game::HandleEvent");
+
     while (SDL_PollEvent(&e))
     {
         ImGui_ImplSDL2_ProcessEvent(&e);
@@ -516,6 +617,87 @@ void Game::SetClearColor(float r, float g, float b, float a)
 void Game::SetFPSLimit(float FPS)
 {
     m_LimitFPS = FPS;
+    m_framePacer.SetTargetFPS(FPS);
+
+    // stutters are measured against the FPS limit, or the display refresh rate when unlimited
+    float budgetFPS = FPS;
+    SDL_DisplayMode mode;
+    if (budgetFPS <= 0.f && SDL_GetWindowDisplayMode(m_pWindow, &mode) == 0 && mode.refresh_rate > 0)
+    {
+        budgetFPS = static_cast<float>(mode.refresh_rate);
+    }
+    m_telemetry.SetFrameBudget(1000.f / (budgetFPS > 0.f ? budgetFPS : 60.f));
+}
+
+FrameTelemetry* Game::GetTelemetry()
+{
+    return &m_telemetry;
+}
+
+FramePacer& Game::GetFramePacer()
+{
+    return m_framePacer;
+}
+
+void Game::SetProfilerVisible(bool visible)
+{
+    m_showProfiler = visible;
+}
+
+JobSystem* Game::GetJobSystem()
+{
+    return &m_jobSystem;
+}
+
+void Game::SetTickRate(float ticksPerSecond)
+{
+    m_fixedDeltaTime = ticksPerSecond > 0.f ? 1.f / ticksPerSecond : 0.f;
+    m_accumulator = 0.f;
+}
+
+float Game::GetTickRate() const
+{
+    return m_fixedDeltaTime > 0.f ? 1.f / m_fixedDeltaTime : 0.f;
+}
+
+void Game::SetMaxStepsPerFrame(int maxSteps)
+{
+    m_maxStepsPerFrame = maxSteps > 0 ? maxSteps : 1;
+}
+
+float Game::GetInterpolationAlpha() const
+{
+    return m_interpolationAlpha;
+}
+
+unsigned long long Game::GetSimulationTick() const
+{
+    return m_simulationTick;
+}
+
+void Game::SetHeadless(bool headless)
+{
+    m_headless = headless;
+}
+
+void Game::SetFixedFrameTime(float seconds)
+{
+    m_fixedFrameTime = seconds;
+}
+
+void Game::SetSoundConfig(const SoundPlayerConfig& config)
+{
+    m_soundConfig = config;
+}
+
+const SoundPlayerConfig& Game::GetSoundConfig() const
+{
+    return m_soundConfig;
+}
+
+void Game::SetInitialState(std::shared_ptr<GameStateBase> state)
+{
+    m_initialState = state;
 }
 
 int Game::GetWindowWidth() const
@@ -528,16 +710,20 @@ int Game::GetWindowHeight() const
     return m_ScreenHeight;
 }
 
-void Game::Draw()
+void Game::Draw(float alpha)
 {
+    PROFILE_SCOPE("Game::Draw");
+
     if (GSM()->HasState())
     {
-        GSM()->GetCurrentState()->Draw();
+        GSM()->GetCurrentState()->Draw(alpha);
     }
 }
 
 void Game::Update(float deltaTime)
 {
+    PROFILE_SCOPE("Game::Update");
+
     // update state change
     GSM()->Update();
     // get current game state and update
@@ -549,6 +735,14 @@ void Game::Update(float deltaTime)
 
 void Game::OnKeyDown(const SDL_KeyboardEvent& keyevent)
 {
+#if defined(GS_PROFILER_ENABLED)
+    // F3 toggles the profiler overlay
+    if (keyevent.keysym.sym == SDLK_F3 && !keyevent.repeat)
+    {
+        m_showProfiler = !m_showProfiler;
+    }
+#endif
+
     if (GSM()->HasState())
     {
         GSM()->GetCurrentState()->OnKeyDown(keyevent);
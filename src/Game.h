@@ -3,10 +3,16 @@
 #include <string>
 #include <chrono>
 #include <vector>
+#include <memory>
 #include <glm/glm.hpp>
 #include "Config.h"
 #include "SingletonDclp.h"
+#include "FramePacer.h"
+#include "FrameTelemetry.h"
+#include "JobSystem.h"
+#include "SoundPlayer.h"
 
+class GameStateBase;
 
 /**
  * @brief Encapsulates the main game functionality and attributes.
@@ -84,6 +90,92 @@ public:
 	 */
 	void SetFPSLimit(float FPS);
 
+	/**
+	 * @brief Gets the frame pacer used to limit the FPS.
+	 * @return Reference to the frame pacer, to tune its tolerance or read the frame jitter.
+	 */
+	FramePacer& GetFramePacer();
+
+	/**
+	 * @brief Gets the frame-time telemetry.
+	 * @return Pointer to the telemetry, to read percentiles and stutters or change the CSV path.
+	 */
+	FrameTelemetry* GetTelemetry();
+
+	/**
+	 * @brief Shows or hides the profiler overlay (toggled with F3 in builds with profiling markers).
+	 * @param visible True to show the flame graph window.
+	 */
+	void SetProfilerVisible(bool visible);
+
+	/**
+	 * @brief Gets the job system shared by the engine and the game states.
+	 * @return Pointer to the job system.
+	 */
+	JobSystem* GetJobSystem();
+
+	/**
+	 * @brief Sets the fixed simulation rate used for Update.
+	 * @param ticksPerSecond Number of simulation steps per second (0 uses the raw frame delta, one update per frame).
+	 */
+	void SetTickRate(float ticksPerSecond);
+
+	/**
+	 * @brief Gets the fixed simulation rate.
+	 * @return Number of simulation steps per second (0 if the simulation follows the frame rate).
+	 */
+	float GetTickRate() const;
+
+	/**
+	 * @brief Sets the maximum number of simulation steps run in a single frame.
+	 * @param maxSteps The step limit (at least 1). Time that can not be caught up is dropped.
+	 */
+	void SetMaxStepsPerFrame(int maxSteps);
+
+	/**
+	 * @brief Gets the interpolation factor between the previous and the current simulation step.
+	 * @return A value in range [0, 1] used to blend object transforms while drawing.
+	 */
+	float GetInterpolationAlpha() const;
+
+	/**
+	 * @brief Gets the number of simulation steps run so far.
+	 * @return The current simulation tick.
+	 */
+	unsigned long long GetSimulationTick() const;
+
+	/**
+	 * @brief Runs the game in a hidden window without VSync. Must be called before Run.
+	 * @param headless True to hide the window.
+	 */
+	void SetHeadless(bool headless);
+
+	/**
+	 * @brief Advances the game clock by a constant amount every frame instead of the measured time.
+	 * @param seconds The frame delta time (0 measures the real time, the default).
+	 *
+	 * Used to make runs deterministic, for example benchmarks and replays.
+	 */
+	void SetFixedFrameTime(float seconds);
+
+	/**
+	 * @brief Sets the settings the sound player is initialized with. Must be called before Run.
+	 * @param config The audio settings, the null driver runs without an audio device.
+	 */
+	void SetSoundConfig(const SoundPlayerConfig& config);
+
+	/**
+	 * @brief Gets the settings the sound player was initialized with.
+	 * @return The audio settings.
+	 */
+	const SoundPlayerConfig& GetSoundConfig() const;
+
+	/**
+	 * @brief Sets the state pushed when the game starts instead of the intro. Must be called before Run.
+	 * @param state The first game state.
+	 */
+	void SetInitialState(std::shared_ptr<GameStateBase> state);
+
 	/**
 	 * @brief Gets the width of the window.
 	 * @return The width of the window in pixel.
@@ -182,6 +274,88 @@ private:
 	 */
 	float m_LimitFPS;
 
+	/**
+	 * @brief Frame pacer enforcing the FPS limit.
+	 *
+	 * Sleeps for most of the remaining frame budget and spins only the last fraction,
+	 * instead of busy-waiting the whole frame.
+	 */
+	FramePacer m_framePacer;
+
+	/**
+	 * @brief Frame-time telemetry.
+	 *
+	 * Records the frame, update, draw and swap times of every frame, flags stutters
+	 * and writes the session to CSV on exit.
+	 */
+	FrameTelemetry m_telemetry;
+
+	/**
+	 * @brief Work-stealing job scheduler.
+	 *
+	 * Runs one worker per core. Asset loading, batch building and other parallel work
+	 * should go through it instead of starting their own threads.
+	 */
+	JobSystem m_jobSystem;
+
+	/**
+	 * @brief Fixed time step of the simulation in seconds.
+	 *
+	 * Update is always called with this value so game logic does not depend on the
+	 * frame rate. A value of 0 falls back to passing the raw frame delta.
+	 */
+	float m_fixedDeltaTime;
+
+	/**
+	 * @brief Accumulated frame time not yet consumed by simulation steps.
+	 *
+	 * The remainder is carried over to the next frame and used to compute
+	 * the interpolation alpha.
+	 */
+	float m_accumulator;
+
+	/**
+	 * @brief Interpolation factor between the previous and current simulation step.
+	 *
+	 * Computed every frame as the leftover accumulated time divided by the fixed step.
+	 */
+	float m_interpolationAlpha;
+
+	/**
+	 * @brief Maximum number of simulation steps per frame.
+	 *
+	 * Prevents the simulation from spiraling when a frame takes longer than
+	 * the steps it has to catch up on.
+	 */
+	int m_maxStepsPerFrame;
+
+	/**
+	 * @brief Number of simulation steps run since the game started.
+	 *
+	 * Objects use this to know whether their previous transform belongs to the last step.
+	 */
+	unsigned long long m_simulationTick;
+
+	/**
+	 * @brief Flag indicating if the window is hidden and VSync disabled.
+	 */
+	bool m_headless;
+
+	/**
+	 * @brief Constant frame delta time in seconds, 0 to use the measured time.
+	 */
+	float m_fixedFrameTime;
+
+	/**
+	 * @brief Settings the sound player is initialized with.
+	 */
+	SoundPlayerConfig m_soundConfig;
+
+	/**
+	 * @brief State pushed on start instead of the intro, if set.
+	 */
+	std::shared_ptr<GameStateBase> m_initialState;
+
 	/**
 	 * @brief Screen height in pixels.
 	 *
@@ -204,6 +378,11 @@ private:
 	 */
 	bool m_GameRunning;
 
+	/**
+	 * @brief Flag indicating if the profiler overlay is drawn.
+	 */
+	bool m_showProfiler;
+
 private:
 	/**
 	 * @brief Initializes SDL (Simple DirectMedia Layer).
@@ -241,12 +420,13 @@ private:
 
 	/**
 	 * @brief Draws the game scene.
+	 * @param alpha Interpolation factor between the previous and the current simulation step.
 	 */
-	void Draw();
+	void Draw(float alpha);
 
 	/**
-	 * @brief Updates the game state based on elapsed time.
-	 * @param deltaTime Time elapsed since the last update.
+	 * @brief Updates the game state by one simulation step.
+	 * @param deltaTime Time step of the update (the fixed tick time when a tick rate is set).
 	 */
 	void Update(float deltaTime);
 
@@ -272,4 +452,10 @@ private:
  * @def GAME
  * @brief Macro to get the singleton instance of the Game class.
  */
-#define GAME() Game::GetInstance()
\ No newline at end of file
+#define GAME() Game::GetInstance()
+
+/**
+ * @def JOBS
+ * @brief Macro to get the job system owned by the Game instance.
+ */
+#define JOBS() Game::GetInstance()->GetJobSystem()
\ No newline at end of file
@@ -7,6 +7,7 @@ enum class GameStateType
 	STATE_INTRO,
 	STATE_MENU,
 	STATE_PLAY,
+	STATE_CUSTOM,	///< State created outside CreateGameState and pushed directly
 	STATE_COUNT
 };
 
@@ -50,8 +51,8 @@ public:
 	virtual void Init() = 0;
 
 	/**
-	 * @brief Updates the game state based on the elapsed time.
-	 * @param deltaTime The time elapsed since the last update.
+	 * @brief Updates the game state by one simulation step.
+	 * @param deltaTime The fixed time step of the simulation (see Game::SetTickRate).
 	 *
 	 * Derived classes should implement this method to update the state's logic
 	 * and handle any state-specific updates.
@@ -59,12 +60,14 @@ public:
 	virtual void Update(float deltaTime) = 0;
 
 	/**
-	 * @brief Draws the current game state. This will be called every game tick.
+	 * @brief Draws the current game state. This will be called every rendered frame.
+	 * @param alpha Interpolation factor between the previous and the current simulation step.
 	 *
 	 * Derived classes should implement this method to render the state's visuals
-	 * and display relevant information to the screen.
+	 * and display relevant information to the screen. Renderers already use the
+	 * alpha to interpolate object transforms, it is passed here for custom drawing.
 	 */
-	virtual void Draw() = 0;
+	virtual void Draw(float alpha) = 0;
 
 	/**
 	 * @brief This method will be called once the current game state is no longer active.
@@ -21,7 +21,16 @@ void GameStateMachine::CleanUp()
 
 void GameStateMachine::PushState(GameStateType stateType)
 {
-    auto newState = CreateGameState(stateType);
+    PushState(CreateGameState(stateType));
+}
+
+void GameStateMachine::PushState(std::shared_ptr<GameStateBase> newState)
+{
+    if (!newState)
+    {
+        return;
+    }
+
     if (m_stateStack.empty())
     {
         m_stateStack.push(newState);
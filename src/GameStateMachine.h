@@ -42,6 +42,14 @@ public:
 	 */
 	void PushState(GameStateType stateType);
 
+	/**
+	 * @brief Pushes an already created game state onto the state stack.
+	 * @param state The game state to push, usually of type STATE_CUSTOM.
+	 *
+	 * Used for states that are not built by CreateGameState, such as benchmark scenarios.
+	 */
+	void PushState(std::shared_ptr<GameStateBase> state);
+
 	/**
 	 * @brief Pops the current game state off the state stack.
 	 *
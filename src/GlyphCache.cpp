@@ -0,0 +1,276 @@
+#include "GlyphCache.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+#include "Game.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+// pages are not grown, so the UVs baked into text meshes stay valid
+static const int GLYPH_PAGE_SIZE = 1024;
+static const int GLYPH_PADDING = 1;
+
+std::map<std::pair<TTF_Font*, bool>, std::unique_ptr<GlyphCache>> GlyphCache::s_caches;
+
+GlyphCache* GlyphCache::Get(TTF_Font* font, bool distanceField)
+{
+	auto key = std::make_pair(font, distanceField);
+	auto it = s_caches.find(key);
+	if (it != s_caches.end())
+	{
+		return it->second.get();
+	}
+
+	GlyphCache* cache = new GlyphCache(font, distanceField);
+	s_caches[key] = std::unique_ptr<GlyphCache>(cache);
+	return cache;
+}
+
+void GlyphCache::Release(TTF_Font* font)
+{
+	s_caches.erase(std::make_pair(font, false));
+	s_caches.erase(std::make_pair(font, true));
+}
+
+void GlyphCache::ReleaseAll()
+{
+	s_caches.clear();
+}
+
+GlyphCache::GlyphCache(TTF_Font* font, bool distanceField) :
+	m_font(font), m_distanceField(distanceField), m_atlas(GLYPH_PAGE_SIZE, GLYPH_PAGE_SIZE, GLYPH_PADDING), m_filterMode(TextureFilterMode::LINEAR), m_filteredPageCount(0)
+{
+}
+
+void GlyphCache::RasterizeRequested()
+{
+	// caches are sorted by font, the coverage and distance field caches of a font stay together
+	std::vector<std::vector<GlyphCache*>> fonts;
+	for (auto& it : s_caches)
+	{
+		if (it.second->m_requested.empty())
+		{
+			continue;
+		}
+		if (fonts.empty() || fonts.back().front()->m_font != it.first.first)
+		{
+			fonts.emplace_back();
+		}
+		fonts.back().push_back(it.second.get());
+	}
+	if (fonts.empty())
+	{
+		return;
+	}
+
+	PROFILE_SCOPE("GlyphCache::RasterizeRequested");
+
+	auto counter = JOBS()->ParallelFor(fonts.size(), 1, [&fonts](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				for (GlyphCache* cache : fonts[i])
+				{
+					cache->m_rasterized.resize(cache->m_requested.size());
+					size_t index = 0;
+					for (Uint32 codepoint : cache->m_requested)
+					{
+						cache->m_rasterized[index].codepoint = codepoint;
+						cache->Rasterize(cache->m_rasterized[index]);
+						index++;
+					}
+				}
+			}
+		});
+	JOBS()->Wait(counter);
+
+	for (auto& font : fonts)
+	{
+		for (GlyphCache* cache : font)
+		{
+			for (auto& glyph : cache->m_rasterized)
+			{
+				cache->Insert(glyph);
+			}
+			cache->m_rasterized.clear();
+			cache->m_requested.clear();
+		}
+	}
+}
+
+const Glyph* GlyphCache::GetGlyph(Uint32 codepoint)
+{
+	auto it = m_glyphs.find(codepoint);
+	if (it != m_glyphs.end())
+	{
+		return it->second.advance >= 0 ? &it->second : nullptr;
+	}
+
+	PROFILE_SCOPE("GlyphCache::GetGlyph");
+
+	RasterizedGlyph glyph;
+	glyph.codepoint = codepoint;
+	Rasterize(glyph);
+	return Insert(glyph);
+}
+
+void GlyphCache::Request(Uint32 codepoint)
+{
+	if (m_glyphs.find(codepoint) == m_glyphs.end())
+	{
+		m_requested.insert(codepoint);
+	}
+}
+
+void GlyphCache::Rasterize(RasterizedGlyph& glyph) const
+{
+	// missing glyphs are remembered too, with a negative advance
+	glyph.offsetX = 0;
+	glyph.offsetY = 0;
+	glyph.width = 0;
+	glyph.height = 0;
+	glyph.advance = -1;
+	glyph.pixels.clear();
+
+	int minX, maxX, minY, maxY, advance;
+	if (!TTF_GlyphIsProvided32(m_font, glyph.codepoint) || TTF_GlyphMetrics32(m_font, glyph.codepoint, &minX, &maxX, &minY, &maxY, &advance) != 0)
+	{
+		return;
+	}
+	glyph.advance = advance;
+	if (maxX <= minX)
+	{
+		// nothing to draw
+		return;
+	}
+
+	// the font may be shared with coverage caches, SDF is only on while rasterizing
+	SDL_bool wasDistanceField = TTF_GetFontSDF(m_font);
+	if (m_distanceField != (wasDistanceField == SDL_TRUE))
+	{
+		TTF_SetFontSDF(m_font, m_distanceField ? SDL_TRUE : SDL_FALSE);
+	}
+	SDL_Surface* surface = TTF_RenderGlyph32_Blended(m_font, glyph.codepoint, { 255, 255, 255, 255 });
+	if (m_distanceField != (wasDistanceField == SDL_TRUE))
+	{
+		TTF_SetFontSDF(m_font, wasDistanceField);
+	}
+
+	SDL_Surface* converted = surface ? SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ABGR8888, 0) : nullptr;
+	SDL_FreeSurface(surface);
+	if (!converted)
+	{
+		LogError("Rendering glyph %u error: %s", glyph.codepoint, TTF_GetError());
+		return;
+	}
+
+	// the surface is the full font height, only the rows with ink are kept
+	auto rowHasInk = [converted](int y)
+		{
+			const unsigned char* row = static_cast<const unsigned char*>(converted->pixels) + static_cast<size_t>(y) * converted->pitch;
+			for (int x = 0; x < converted->w; x++)
+			{
+				if (row[x * 4 + 3] != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+	int top = 0;
+	int bottom = converted->h;
+	while (top < bottom && !rowHasInk(top))
+	{
+		top++;
+	}
+	while (bottom > top && !rowHasInk(bottom - 1))
+	{
+		bottom--;
+	}
+	if (top == bottom)
+	{
+		// nothing to draw
+		SDL_FreeSurface(converted);
+		return;
+	}
+
+	// ABGR8888 is R, G, B, A in memory, copied without the row padding
+	glyph.pixels.resize(static_cast<size_t>(converted->w) * (bottom - top) * 4);
+	for (int y = top; y < bottom; y++)
+	{
+		const unsigned char* row = static_cast<const unsigned char*>(converted->pixels) + static_cast<size_t>(y) * converted->pitch;
+		std::copy(row, row + converted->w * 4, glyph.pixels.begin() + static_cast<size_t>(y - top) * converted->w * 4);
+	}
+
+	// the surface starts at the pen, or left of it when the glyph overhangs
+	glyph.offsetX = std::min(minX, 0);
+	glyph.offsetY = top;
+	glyph.width = converted->w;
+	glyph.height = bottom - top;
+	SDL_FreeSurface(converted);
+}
+
+const Glyph* GlyphCache::Insert(RasterizedGlyph& rasterized)
+{
+	Glyph& glyph = m_glyphs[rasterized.codepoint];
+	glyph.offsetX = rasterized.offsetX;
+	glyph.offsetY = rasterized.offsetY;
+	glyph.width = rasterized.width;
+	glyph.height = rasterized.height;
+	glyph.advance = rasterized.advance;
+	if (rasterized.pixels.empty())
+	{
+		return glyph.advance >= 0 ? &glyph : nullptr;
+	}
+
+	glyph.image = m_atlas.Add(std::to_string(rasterized.codepoint), rasterized.pixels.data(), rasterized.width, rasterized.height);
+	rasterized.pixels = std::vector<unsigned char>();
+
+	if (m_atlas.GetPageCount() > m_filteredPageCount)
+	{
+		for (size_t i = m_filteredPageCount; i < m_atlas.GetPageCount(); i++)
+		{
+			m_atlas.GetPage(i)->SetFilter(m_filterMode);
+		}
+		m_filteredPageCount = m_atlas.GetPageCount();
+	}
+	return &glyph;
+}
+
+int GlyphCache::GetKerning(Uint32 previous, Uint32 codepoint) const
+{
+	return TTF_GetFontKerningSizeGlyphs32(m_font, previous, codepoint);
+}
+
+int GlyphCache::GetHeight() const
+{
+	return TTF_FontHeight(m_font);
+}
+
+int GlyphCache::GetLineSkip() const
+{
+	return TTF_FontLineSkip(m_font);
+}
+
+void GlyphCache::SetFilter(TextureFilterMode mode)
+{
+	m_filterMode = m_distanceField ? TextureFilterMode::LINEAR : mode;
+	for (size_t i = 0; i < m_atlas.GetPageCount(); i++)
+	{
+		m_atlas.GetPage(i)->SetFilter(m_filterMode);
+	}
+	m_filteredPageCount = m_atlas.GetPageCount();
+}
+
+bool GlyphCache::IsDistanceField() const
+{
+	return m_distanceField;
+}
+
+size_t GlyphCache::GetGlyphCount() const
+{
+	return m_glyphs.size();
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <SDL2/SDL_ttf.h>
+#include "TextureAtlas.h"
+
+class Texture;
+enum class TextureFilterMode;
+
+/**
+ * @brief A glyph rasterized into a glyph cache.
+ */
+struct Glyph
+{
+	std::shared_ptr<Texture> image;		///< The glyph in the atlas, nullptr for blank glyphs such as spaces.
+	int offsetX;						///< Left of the image from the pen position.
+	int offsetY;						///< Top of the image from the top of the line.
+	int width;							///< Width of the image.
+	int height;							///< Height of the image, only the rows with ink.
+	int advance;						///< Pen movement to the next glyph.
+};
+
+/**
+ * @class GlyphCache
+ * @brief Rasterizes each glyph of a font once, white on transparent, into an atlas.
+ *
+ * Text builds its quads from the cached glyphs and tints them in the shader, so changing a
+ * string or its color only rewrites vertices. There is one cache per font. Pages never grow,
+ * a full page opens a new one, so glyphs already placed keep their UVs. Glyph images are cropped
+ * to their ink rows, so a page holds many more glyphs than full height cells would allow.
+ *
+ * A distance field cache stores signed distance fields instead of coverage (SDL_ttf SDF
+ * rendering, the edge at alpha 0.5). Drawn with the text_sdf shader, one rasterization
+ * stays sharp at any scale.
+ *
+ * Glyphs can also be requested ahead and rasterized in one batch by RasterizeRequested,
+ * one job worker per font, leaving only the atlas upload to the GL thread.
+ */
+class GlyphCache
+{
+public:
+	/**
+	 * @brief Gets the cache of a font, creating it on first use.
+	 * @param font The font.
+	 * @param distanceField True for the distance field glyphs of the font.
+	 * @return The cache of the font.
+	 */
+	static GlyphCache* Get(TTF_Font* font, bool distanceField = false);
+
+	/**
+	 * @brief Deletes the caches of a font. Must be called before the font is closed.
+	 * @param font The font.
+	 */
+	static void Release(TTF_Font* font);
+
+	/**
+	 * @brief Deletes all caches. Called when all resources are freed.
+	 */
+	static void ReleaseAll();
+
+	/**
+	 * @brief Rasterizes the glyphs requested in every cache on the job workers, then adds them to the atlases.
+	 *
+	 * Each font is rasterized by a single worker, fonts are not thread safe. Must be called on the GL thread.
+	 */
+	static void RasterizeRequested();
+
+	/**
+	 * @brief Gets a glyph, rasterizing it on first use.
+	 * @param codepoint The unicode codepoint.
+	 * @return The glyph, nullptr if the font does not provide it.
+	 */
+	const Glyph* GetGlyph(Uint32 codepoint);
+
+	/**
+	 * @brief Requests a glyph for the next RasterizeRequested. Does nothing if it is cached.
+	 * @param codepoint The unicode codepoint.
+	 */
+	void Request(Uint32 codepoint);
+
+	/**
+	 * @brief Gets the kerning between two glyphs.
+	 * @param previous The codepoint before.
+	 * @param codepoint The codepoint after.
+	 * @return The pen adjustment in pixels.
+	 */
+	int GetKerning(Uint32 previous, Uint32 codepoint) const;
+
+	/**
+	 * @brief Gets the height of a line of glyphs.
+	 * @return The font height in pixels.
+	 */
+	int GetHeight() const;
+
+	/**
+	 * @brief Gets the distance between two lines.
+	 * @return The line skip in pixels.
+	 */
+	int GetLineSkip() const;
+
+	/**
+	 * @brief Sets the filtering of the atlas pages, shared by every text using the font.
+	 * @param mode NEAREST or LINEAR. Distance fields are always filtered linearly.
+	 */
+	void SetFilter(TextureFilterMode mode);
+
+	/**
+	 * @brief Checks if the glyphs are distance fields.
+	 * @return True for a distance field cache.
+	 */
+	bool IsDistanceField() const;
+
+	/**
+	 * @brief Gets the number of glyphs rasterized.
+	 * @return The glyph count.
+	 */
+	size_t GetGlyphCount() const;
+
+private:
+	/**
+	 * @brief A glyph rasterized on the CPU, not in the atlas yet.
+	 */
+	struct RasterizedGlyph
+	{
+		Uint32 codepoint;					///< The unicode codepoint.
+		int offsetX;						///< Left of the image from the pen position.
+		int offsetY;						///< Top of the image from the top of the line.
+		int width;							///< Width of the image.
+		int height;							///< Height of the image.
+		int advance;						///< Pen movement to the next glyph, negative when the font does not provide it.
+		std::vector<unsigned char> pixels;	///< The RGBA image, empty for blank glyphs.
+	};
+
+	/**
+	 * @brief Constructs the cache of a font.
+	 * @param font The font.
+	 * @param distanceField True to rasterize distance fields.
+	 */
+	GlyphCache(TTF_Font* font, bool distanceField);
+
+	/**
+	 * @brief Rasterizes a glyph without touching the atlas, safe on a job worker.
+	 * @param glyph The glyph, its codepoint set.
+	 */
+	void Rasterize(RasterizedGlyph& glyph) const;
+
+	/**
+	 * @brief Adds a rasterized glyph to the cache and its image to the atlas.
+	 * @param glyph The glyph, its pixels are consumed.
+	 * @return The glyph, nullptr if the font does not provide it.
+	 */
+	const Glyph* Insert(RasterizedGlyph& glyph);
+
+	TTF_Font* m_font;								///< The font.
+	bool m_distanceField;							///< True when the glyphs are distance fields.
+	TextureAtlas m_atlas;							///< Pages holding the glyph images.
+	std::unordered_map<Uint32, Glyph> m_glyphs;		///< Glyphs by codepoint, missing glyphs included.
+	TextureFilterMode m_filterMode;					///< Filtering of the pages.
+	size_t m_filteredPageCount;						///< Pages the filtering was applied to.
+	std::unordered_set<Uint32> m_requested;			///< Glyphs waiting for RasterizeRequested.
+	std::vector<RasterizedGlyph> m_rasterized;		///< Glyphs rasterized by the workers, waiting for the atlas.
+
+	static std::map<std::pair<TTF_Font*, bool>, std::unique_ptr<GlyphCache>> s_caches;	///< The caches by font and distance field flag.
+};
\ No newline at end of file
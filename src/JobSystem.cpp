@@ -0,0 +1,278 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+
+// index of the queue owned by the current thread, threads not started by the job system share queue 0
+static thread_local size_t t_queueIndex = 0;
+
+JobCounter::JobCounter() : m_value(0)
+{
+}
+
+bool JobCounter::IsDone() const
+{
+	return m_value.load(std::memory_order_acquire) == 0;
+}
+
+int JobCounter::GetValue() const
+{
+	return m_value.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem() : m_running(false), m_queuedJobCount(0)
+{
+}
+
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+void JobSystem::Init(unsigned int workerCount)
+{
+	if (m_running)
+	{
+		return;
+	}
+
+	if (workerCount == 0)
+	{
+		// the main thread also executes jobs while it waits
+		unsigned int cores = std::thread::hardware_concurrency();
+		workerCount = cores > 1 ? cores - 1 : 1;
+	}
+
+	m_queues.clear();
+	for (unsigned int i = 0; i <= workerCount; i++)
+	{
+		m_queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	m_running = true;
+	for (unsigned int i = 1; i <= workerCount; i++)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	LogInfo("Job system started with %u workers", workerCount);
+}
+
+void JobSystem::Shutdown()
+{
+	if (!m_running)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_running = false;
+	}
+	m_wakeCondition.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	// finish whatever is left on the calling thread
+	while (TryExecuteJob(0))
+	{
+	}
+	m_queues.clear();
+}
+
+std::shared_ptr<JobCounter> JobSystem::Run(std::function<void()> job, const std::shared_ptr<JobCounter>& dependency)
+{
+	auto counter = std::make_shared<JobCounter>();
+	Run(std::move(job), counter, dependency);
+	return counter;
+}
+
+void JobSystem::Run(std::function<void()> job, const std::shared_ptr<JobCounter>& counter, const std::shared_ptr<JobCounter>& dependency)
+{
+	if (counter)
+	{
+		counter->m_value.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	JobCounter::PendingJob pending{ std::move(job), counter };
+
+	if (dependency)
+	{
+		// park the job on the dependency, it is submitted by the job that brings the counter to zero
+		std::lock_guard<std::mutex> lock(dependency->m_mutex);
+		if (!dependency->IsDone())
+		{
+			dependency->m_waitingJobs.push_back(std::move(pending));
+			return;
+		}
+	}
+
+	Submit(std::move(pending));
+}
+
+std::shared_ptr<JobCounter> JobSystem::ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& func, const std::shared_ptr<JobCounter>& dependency)
+{
+	auto counter = std::make_shared<JobCounter>();
+	if (count == 0)
+	{
+		return counter;
+	}
+
+	if (batchSize == 0)
+	{
+		// a few batches per thread so stealing can balance uneven work
+		size_t batchCount = std::max<size_t>(m_queues.size(), 1) * 4;
+		batchSize = std::max<size_t>((count + batchCount - 1) / batchCount, 1);
+	}
+
+	for (size_t begin = 0; begin < count; begin += batchSize)
+	{
+		size_t end = std::min(begin + batchSize, count);
+		Run([func, begin, end]() { func(begin, end); }, counter, dependency);
+	}
+	return counter;
+}
+
+void JobSystem::Wait(const std::shared_ptr<JobCounter>& counter)
+{
+	if (!counter)
+	{
+		return;
+	}
+
+	while (!counter->IsDone())
+	{
+		if (!TryExecuteJob(t_queueIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+unsigned int JobSystem::GetWorkerCount() const
+{
+	return static_cast<unsigned int>(m_workers.size());
+}
+
+void JobSystem::Submit(JobCounter::PendingJob&& job)
+{
+	if (m_queues.empty())
+	{
+		// not initialized, run in place
+		Execute(job);
+		return;
+	}
+
+	WorkQueue& queue = *m_queues[t_queueIndex];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+	{
+		// take the sleep lock so a worker can not miss the wake up between its check and its wait
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queuedJobCount.fetch_add(1, std::memory_order_release);
+	}
+	m_wakeCondition.notify_one();
+}
+
+bool JobSystem::TryExecuteJob(size_t queueIndex)
+{
+	if (m_queues.empty())
+	{
+		return false;
+	}
+
+	JobCounter::PendingJob job;
+	bool found = false;
+
+	// newest job from the own queue, it is most likely still in cache
+	{
+		WorkQueue& queue = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	// oldest job from another queue
+	for (size_t i = 1; i < m_queues.size() && !found; i++)
+	{
+		WorkQueue& victim = *m_queues[(queueIndex + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty())
+		{
+			job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	m_queuedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+	Execute(job);
+	return true;
+}
+
+void JobSystem::Execute(JobCounter::PendingJob& job)
+{
+	if (job.func)
+	{
+		job.func();
+	}
+
+	if (!job.counter)
+	{
+		return;
+	}
+
+	if (job.counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		// last job of the counter, release everything that depends on it
+		std::vector<JobCounter::PendingJob> released;
+		{
+			std::lock_guard<std::mutex> lock(job.counter->m_mutex);
+			released.swap(job.counter->m_waitingJobs);
+		}
+		for (auto& waitingJob : released)
+		{
+			Submit(std::move(waitingJob));
+		}
+	}
+}
+
+void JobSystem::WorkerLoop(size_t queueIndex)
+{
+	t_queueIndex = queueIndex;
+
+	while (true)
+	{
+		if (TryExecuteJob(queueIndex))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wakeCondition.wait(lock, [this]()
+			{
+				return !m_running || m_queuedJobCount.load(std::memory_order_acquire) > 0;
+			});
+
+		if (!m_running)
+		{
+			break;
+		}
+	}
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JobCounter
+ * @brief Tracks a group of jobs that are not finished yet.
+ *
+ * Every job started with a counter increments it and decrements it when done.
+ * Jobs can depend on a counter, they are held back until the counter reaches zero.
+ */
+class JobCounter
+{
+public:
+	/**
+	 * @brief Constructs a counter with no pending job.
+	 */
+	JobCounter();
+
+	/**
+	 * @brief Checks if every job attached to the counter has finished.
+	 * @return True if there is no pending job.
+	 */
+	bool IsDone() const;
+
+	/**
+	 * @brief Gets the number of pending jobs.
+	 * @return The number of jobs attached to the counter that have not finished.
+	 */
+	int GetValue() const;
+
+	friend class JobSystem;		///< Grants JobSystem access to the counter internals.
+private:
+	struct PendingJob
+	{
+		std::function<void()> func;
+		std::shared_ptr<JobCounter> counter;
+	};
+
+	std::atomic<int> m_value;						///< Number of pending jobs.
+	std::mutex m_mutex;								///< Guards the list of jobs waiting on this counter.
+	std::vector<PendingJob> m_waitingJobs;			///< Jobs released once the counter reaches zero.
+};
+
+/**
+ * @class JobSystem
+ * @brief Work-stealing job scheduler with one worker thread per core.
+ *
+ * Each worker owns a job queue. A worker pushes and pops its own queue from the back
+ * and steals from the front of the other queues when it runs out of work.
+ * Threads waiting on a counter help executing jobs instead of blocking.
+ * The instance is owned by Game, use the JOBS() macro to access it.
+ */
+class JobSystem
+{
+public:
+	/**
+	 * @brief Constructs a job system with no worker. Call Init to start the workers.
+	 */
+	JobSystem();
+
+	/**
+	 * @brief Stops the workers if they are still running.
+	 */
+	~JobSystem();
+
+	/**
+	 * @brief Starts the worker threads.
+	 * @param workerCount Number of workers (0 uses one worker per core, minus the main thread).
+	 */
+	void Init(unsigned int workerCount = 0);
+
+	/**
+	 * @brief Finishes the queued jobs and joins the worker threads.
+	 */
+	void Shutdown();
+
+	/**
+	 * @brief Schedules a job.
+	 * @param job The function to run on a worker thread.
+	 * @param dependency Optional counter the job waits on before it can start.
+	 * @return A counter that reaches zero when the job has finished.
+	 */
+	std::shared_ptr<JobCounter> Run(std::function<void()> job, const std::shared_ptr<JobCounter>& dependency = nullptr);
+
+	/**
+	 * @brief Schedules a job and attaches it to an existing counter.
+	 * @param job The function to run on a worker thread.
+	 * @param counter The counter to increment, it is decremented when the job has finished.
+	 * @param dependency Optional counter the job waits on before it can start.
+	 */
+	void Run(std::function<void()> job, const std::shared_ptr<JobCounter>& counter, const std::shared_ptr<JobCounter>& dependency);
+
+	/**
+	 * @brief Splits a range into batches and runs them in parallel.
+	 * @param count The number of elements in the range [0, count).
+	 * @param batchSize The number of elements per job (0 picks a size from the worker count).
+	 * @param func The function called with the [begin, end) range of each batch.
+	 * @param dependency Optional counter the batches wait on before they can start.
+	 * @return A counter that reaches zero when all batches have finished.
+	 */
+	std::shared_ptr<JobCounter> ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& func, const std::shared_ptr<JobCounter>& dependency = nullptr);
+
+	/**
+	 * @brief Waits until a counter reaches zero, executing queued jobs in the meantime.
+	 * @param counter The counter to wait for.
+	 */
+	void Wait(const std::shared_ptr<JobCounter>& counter);
+
+	/**
+	 * @brief Gets the number of worker threads.
+	 * @return The worker count.
+	 */
+	unsigned int GetWorkerCount() const;
+
+private:
+	/**
+	 * @brief A job queue owned by one thread, other threads steal from it.
+	 */
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<JobCounter::PendingJob> jobs;
+	};
+
+	std::vector<std::unique_ptr<WorkQueue>> m_queues;	///< Queue 0 belongs to the main thread, then one per worker.
+	std::vector<std::thread> m_workers;					///< Worker threads.
+	std::atomic<bool> m_running;						///< Cleared to stop the workers.
+	std::atomic<int> m_queuedJobCount;					///< Number of jobs waiting in the queues.
+	std::mutex m_sleepMutex;							///< Guards idle workers going to sleep.
+	std::condition_variable m_wakeCondition;			///< Wakes idle workers when a job is queued.
+
+	/**
+	 * @brief Pushes a job whose dependencies are met into the queue of the calling thread.
+	 * @param job The job to queue.
+	 */
+	void Submit(JobCounter::PendingJob&& job);
+
+	/**
+	 * @brief Runs one job from the own queue, or steals one from another queue.
+	 * @param queueIndex The queue owned by the calling thread.
+	 * @return True if a job was executed.
+	 */
+	bool TryExecuteJob(size_t queueIndex);
+
+	/**
+	 * @brief Executes a job and releases the jobs waiting on its counter.
+	 * @param job The job to execute.
+	 */
+	void Execute(JobCounter::PendingJob& job);
+
+	/**
+	 * @brief Main loop of a worker thread.
+	 * @param queueIndex The queue owned by the worker.
+	 */
+	void WorkerLoop(size_t queueIndex);
+};
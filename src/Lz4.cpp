@@ -0,0 +1,204 @@
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static const size_t MIN_MATCH = 4;			// shortest match the format can encode
+static const size_t LAST_LITERALS = 5;		// the block always ends with this many literals
+static const size_t MATCH_FIND_LIMIT = 12;	// no match may start closer than this to the end
+static const size_t MAX_OFFSET = 65535;
+static const int HASH_LOG = 16;
+
+static uint32_t Read32(const unsigned char* pointer)
+{
+	uint32_t value;
+	std::memcpy(&value, pointer, sizeof(value));
+	return value;
+}
+
+static uint32_t Hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// writes the part of a length that does not fit in the token
+static unsigned char* WriteLength(unsigned char* output, size_t length)
+{
+	while (length >= 255)
+	{
+		*output++ = 255;
+		length -= 255;
+	}
+	*output++ = static_cast<unsigned char>(length);
+	return output;
+}
+
+static bool ReadLength(const unsigned char* source, size_t sourceSize, size_t& position, size_t& length)
+{
+	unsigned char byte;
+	do
+	{
+		if (position >= sourceSize)
+		{
+			return false;
+		}
+		byte = source[position++];
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+size_t Lz4::GetMaxCompressedSize(size_t sourceSize)
+{
+	return sourceSize + sourceSize / 255 + 16;
+}
+
+size_t Lz4::Compress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationCapacity)
+{
+	if (destinationCapacity < GetMaxCompressedSize(sourceSize))
+	{
+		return 0;
+	}
+
+	// positions of the last 4 byte sequences seen, by hash
+	thread_local std::vector<uint32_t> table;
+	table.assign(size_t(1) << HASH_LOG, 0);
+
+	unsigned char* output = destination;
+	size_t anchor = 0;
+	size_t position = 0;
+
+	auto emitSequence = [&](size_t literalEnd, size_t offset, size_t matchLength)
+		{
+			size_t literalLength = literalEnd - anchor;
+			unsigned char* token = output++;
+			*token = static_cast<unsigned char>((literalLength < 15 ? literalLength : 15) << 4);
+			if (literalLength >= 15)
+			{
+				output = WriteLength(output, literalLength - 15);
+			}
+			if (literalLength > 0)
+			{
+				std::memcpy(output, source + anchor, literalLength);
+				output += literalLength;
+			}
+
+			if (matchLength == 0)
+			{
+				return;
+			}
+			*output++ = static_cast<unsigned char>(offset & 0xFF);
+			*output++ = static_cast<unsigned char>(offset >> 8);
+			size_t code = matchLength - MIN_MATCH;
+			*token |= static_cast<unsigned char>(code < 15 ? code : 15);
+			if (code >= 15)
+			{
+				output = WriteLength(output, code - 15);
+			}
+		};
+
+	if (sourceSize > MATCH_FIND_LIMIT)
+	{
+		size_t matchStartLimit = sourceSize - MATCH_FIND_LIMIT;
+		size_t matchEndLimit = sourceSize - LAST_LITERALS;
+		while (position < matchStartLimit)
+		{
+			uint32_t sequence = Read32(source + position);
+			uint32_t& slot = table[Hash(sequence)];
+			size_t candidate = slot;
+			slot = static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > MAX_OFFSET || Read32(source + candidate) != sequence)
+			{
+				// skip faster through data that does not compress
+				position += 1 + ((position - anchor) >> 6);
+				continue;
+			}
+
+			size_t matchLength = MIN_MATCH;
+			while (position + matchLength < matchEndLimit && source[candidate + matchLength] == source[position + matchLength])
+			{
+				matchLength++;
+			}
+
+			emitSequence(position, position - candidate, matchLength);
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	// the remaining bytes are stored as literals
+	emitSequence(sourceSize, 0, 0);
+	return static_cast<size_t>(output - destination);
+}
+
+bool Lz4::Decompress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize)
+{
+	size_t input = 0;
+	size_t output = 0;
+	while (input < sourceSize)
+	{
+		unsigned char token = source[input++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(source, sourceSize, input, literalLength))
+		{
+			return false;
+		}
+		if (literalLength > sourceSize - input || literalLength > destinationSize - output)
+		{
+			return false;
+		}
+		if (literalLength > 0)
+		{
+			std::memcpy(destination + output, source + input, literalLength);
+		}
+		input += literalLength;
+		output += literalLength;
+
+		// the last sequence has no match
+		if (input == sourceSize)
+		{
+			break;
+		}
+
+		if (sourceSize - input < 2)
+		{
+			return false;
+		}
+		size_t offset = source[input] | (source[input + 1] << 8);
+		input += 2;
+		if (offset == 0 || offset > output)
+		{
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(source, sourceSize, input, matchLength))
+		{
+			return false;
+		}
+		matchLength += MIN_MATCH;
+		if (matchLength > destinationSize - output)
+		{
+			return false;
+		}
+
+		// a match can overlap the bytes it produces, which repeats them
+		const unsigned char* match = destination + output - offset;
+		if (offset >= matchLength)
+		{
+			std::memcpy(destination + output, match, matchLength);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				destination[output + i] = match[i];
+			}
+		}
+		output += matchLength;
+	}
+	return output == destinationSize;
+}
\ No newline at end of file
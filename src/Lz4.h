@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Compression in the LZ4 block format.
+ *
+ * A small greedy compressor and a bounds checked decompressor, enough for the
+ * resource caches. Blocks are compatible with the reference LZ4 implementation.
+ */
+namespace Lz4
+{
+	/**
+	 * @brief Gets the largest size a compressed block can have.
+	 * @param sourceSize The size of the data to compress.
+	 * @return The buffer size to pass to Compress.
+	 */
+	size_t GetMaxCompressedSize(size_t sourceSize);
+
+	/**
+	 * @brief Compresses a block.
+	 * @param source The data to compress.
+	 * @param sourceSize The size of the data.
+	 * @param destination The output buffer.
+	 * @param destinationCapacity The size of the output buffer, see GetMaxCompressedSize.
+	 * @return The compressed size, 0 if the output buffer is too small.
+	 */
+	size_t Compress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationCapacity);
+
+	/**
+	 * @brief Decompresses a block.
+	 * @param source The compressed block.
+	 * @param sourceSize The size of the block.
+	 * @param destination The output buffer.
+	 * @param destinationSize The exact size of the decompressed data.
+	 * @return True if the block is valid and fills the output buffer exactly.
+	 */
+	bool Decompress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize);
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Maps a whole file read-only into memory.
+ *
+ * The pages are loaded by the OS on first access, so reading a cache file costs
+ * no copy into a user buffer. The mapping is released with the object.
+ */
+class MappedFile
+{
+public:
+	/**
+	 * @brief Constructs a closed file.
+	 */
+	MappedFile();
+
+	/**
+	 * @brief Destructor. Unmaps the file.
+	 */
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * @brief Maps a file, closing the one mapped before.
+	 * @param path The path to the file.
+	 * @return True if the file exists, is not empty and was mapped.
+	 */
+	bool Open(const std::string& path);
+
+	/**
+	 * @brief Unmaps the file.
+	 */
+	void Close();
+
+	/**
+	 * @brief Checks if a file is mapped.
+	 * @return True if a file is mapped.
+	 */
+	bool IsOpen() const;
+
+	/**
+	 * @brief Gets the content of the file.
+	 * @return The first byte, nullptr if no file is mapped.
+	 */
+	const unsigned char* GetData() const;
+
+	/**
+	 * @brief Gets the size of the file.
+	 * @return The size in bytes, 0 if no file is mapped.
+	 */
+	size_t GetSize() const;
+
+private:
+	const unsigned char* m_data;	///< The mapped content.
+	size_t m_size;					///< Size of the file.
+	void* m_file;					///< File handle on Windows.
+	void* m_mapping;				///< Mapping handle on Windows.
+};
\ No newline at end of file
@@ -11,12 +11,13 @@ Mesh::Mesh()
 
 Mesh::~Mesh()
 {
+    glDeleteVertexArrays(1, &m_iVAO);
     glDeleteBuffers(1, &m_iVBO);
     glDeleteBuffers(1, &m_iIBO);
 }
 
 Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<GLuint>&& indices) : 
-    m_vertices(std::move(vertices)), m_indices(std::move(m_indices)), m_iVAO(0), m_iVBO(0), m_iIBO(0)
+    m_vertices(std::move(vertices)), m_indices(std::move(indices)), m_iVAO(0), m_iVBO(0), m_iIBO(0)
 {
     m_numIndices = (int)m_indices.size();
 }
@@ -25,6 +26,7 @@ Mesh::Mesh(const Mesh& other)
 {
     m_vertices = other.m_vertices;
     m_indices = other.m_indices;
+    m_ranges = other.m_ranges;
     m_numIndices = other.m_numIndices;
 
     GenerateGLBuffer();
@@ -87,11 +89,29 @@ GLuint Mesh::GetNumIndices() const
     return m_numIndices;
 }
 
-void Mesh::GenerateGLBuffer(bool freeOld)
+void Mesh::UpdateBuffers()
+{
+    m_numIndices = static_cast<GLuint>(m_indices.size());
+    if (m_iVAO == 0)
+    {
+        GenerateGLBuffer(false, GL_DYNAMIC_DRAW);
+        return;
+    }
+
+    // a new store each time, the driver does not wait for draws still reading the old one
+    glBindVertexArray(m_iVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_numIndices * sizeof(GLuint), m_indices.data(), GL_DYNAMIC_DRAW);
+    glBindVertexArray(0);
+}
+
+void Mesh::GenerateGLBuffer(bool freeOld, GLenum usage)
 {
     if (freeOld)
     {
-        glDeleteBuffers(1, &m_iVAO);
+        glDeleteVertexArrays(1, &m_iVAO);
         glDeleteBuffers(1, &m_iVBO);
         glDeleteBuffers(1, &m_iIBO);
         m_iVAO = m_iVBO = m_iIBO = 0;
@@ -104,7 +124,7 @@ void Mesh::GenerateGLBuffer(bool freeOld)
     glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
 
     // VBO setup
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), usage);
     GLenum error = glGetError();
     if (error != GL_NO_ERROR)
     {
@@ -123,7 +143,7 @@ void Mesh::GenerateGLBuffer(bool freeOld)
     // send IBO data to GPU
     glGenBuffers(1, &m_iIBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_numIndices * sizeof(GLuint), m_indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_numIndices * sizeof(GLuint), m_indices.data(), usage);
     error = glGetError();
     if (error != GL_NO_ERROR)
     {
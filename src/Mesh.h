@@ -1,12 +1,26 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <cstdio>
 #include "Vertex.h"
 
+class Texture;
+
+/**
+ * @struct MeshRange
+ * @brief A run of indices drawn with its own texture, such as the glyphs of a text on one atlas page.
+ */
+struct MeshRange
+{
+	std::shared_ptr<Texture> texture;	///< The texture bound for the run.
+	size_t firstIndex;					///< First index of the run.
+	size_t indexCount;					///< Number of indices in the run.
+};
+
 /**
  * @class Mesh
  * @brief Represents a 3D mesh composed of vertices and indices.
@@ -71,9 +85,17 @@ public:
 	 */
 	GLuint GetNumIndices() const;
 
+	/**
+	 * @brief Uploads m_vertices and m_indices, creating the buffers on the first call.
+	 *
+	 * Meant for meshes rebuilt often, such as text. The buffers are created for dynamic use.
+	 */
+	void UpdateBuffers();
+
 public:
 	std::vector<Vertex> m_vertices; ///< The vertices of the mesh.
 	std::vector<GLuint> m_indices;  ///< The indices of the mesh.
+	std::vector<MeshRange> m_ranges;	///< Runs drawn with their own texture, empty to draw every index with the object texture.
 
 private:
 	GLuint m_iVBO;			///< The Vertex Buffer Object (VBO) ID.
@@ -84,6 +106,7 @@ private:
 	/**
 	 * @brief Generates OpenGL buffers for the mesh from defined data.
 	 * @param freeOld Indicates whether to free old buffers if they exist.
+	 * @param usage The buffer usage hint.
 	 */
-	void GenerateGLBuffer(bool freeOld = false);
+	void GenerateGLBuffer(bool freeOld = false, GLenum usage = GL_STATIC_DRAW);
 };
\ No newline at end of file
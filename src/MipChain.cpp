@@ -0,0 +1,113 @@
+#include "MipChain.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIPCHAIN_SSE2
+#endif
+
+#ifdef MIPCHAIN_SSE2
+static __m128 LoadPixel(const unsigned char* pixel)
+{
+	int32_t value;
+	std::memcpy(&value, pixel, sizeof(value));
+	__m128i zero = _mm_setzero_si128();
+	__m128i bytes = _mm_cvtsi32_si128(value);
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+
+static __m128 Premultiply(__m128 pixel)
+{
+	return _mm_mul_ps(pixel, _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+#endif // MIPCHAIN_SSE2
+
+// averages a 2x2 block, the color weighted by alpha
+static void AverageBlock(const unsigned char* p0, const unsigned char* p1, const unsigned char* p2, const unsigned char* p3, unsigned char* out)
+{
+#ifdef MIPCHAIN_SSE2
+	__m128 a = LoadPixel(p0), b = LoadPixel(p1), c = LoadPixel(p2), d = LoadPixel(p3);
+	__m128 sum = _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d));
+	__m128 weighted = _mm_add_ps(_mm_add_ps(Premultiply(a), Premultiply(b)), _mm_add_ps(Premultiply(c), Premultiply(d)));
+	__m128 alphaSum = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 3, 3));
+
+	// a fully transparent block keeps its plain average color
+	__m128 visible = _mm_cmpgt_ps(alphaSum, _mm_setzero_ps());
+	__m128 color = _mm_div_ps(weighted, _mm_max_ps(alphaSum, _mm_set1_ps(1.f)));
+	color = _mm_or_ps(_mm_and_ps(visible, color), _mm_andnot_ps(visible, _mm_mul_ps(sum, _mm_set1_ps(0.25f))));
+
+	// the alpha lane is the plain average
+	__m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	__m128 result = _mm_or_ps(_mm_andnot_ps(alphaMask, color), _mm_and_ps(alphaMask, _mm_mul_ps(sum, _mm_set1_ps(0.25f))));
+
+	__m128i integers = _mm_cvttps_epi32(_mm_add_ps(result, _mm_set1_ps(0.5f)));
+	integers = _mm_packs_epi32(integers, integers);
+	integers = _mm_packus_epi16(integers, integers);
+	int32_t value = _mm_cvtsi128_si32(integers);
+	std::memcpy(out, &value, sizeof(value));
+#else
+	int alphaSum = p0[3] + p1[3] + p2[3] + p3[3];
+	for (int c = 0; c < 3; c++)
+	{
+		if (alphaSum > 0)
+		{
+			int weighted = p0[c] * p0[3] + p1[c] * p1[3] + p2[c] * p2[3] + p3[c] * p3[3];
+			out[c] = static_cast<unsigned char>(std::min((weighted + alphaSum / 2) / alphaSum, 255));
+		}
+		else
+		{
+			out[c] = static_cast<unsigned char>((p0[c] + p1[c] + p2[c] + p3[c] + 2) / 4);
+		}
+	}
+	out[3] = static_cast<unsigned char>((alphaSum + 2) / 4);
+#endif // MIPCHAIN_SSE2
+}
+
+int MipChain::GetLevelCount(int width, int height)
+{
+	int levelCount = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+		levelCount++;
+	}
+	return levelCount;
+}
+
+void MipChain::Build(const unsigned char* pixels, int width, int height, std::vector<MipLevel>& levels)
+{
+	levels.clear();
+	levels.reserve(GetLevelCount(width, height) - 1);
+
+	const unsigned char* source = pixels;
+	while (width > 1 || height > 1)
+	{
+		MipLevel level;
+		level.width = std::max(width / 2, 1);
+		level.height = std::max(height / 2, 1);
+		level.pixels.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+		// the last row or column is repeated when a side is odd or 1
+		for (int y = 0; y < level.height; y++)
+		{
+			const unsigned char* row0 = source + static_cast<size_t>(std::min(y * 2, height - 1)) * width * 4;
+			const unsigned char* row1 = source + static_cast<size_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+			unsigned char* out = &level.pixels[static_cast<size_t>(y) * level.width * 4];
+			for (int x = 0; x < level.width; x++)
+			{
+				int x0 = std::min(x * 2, width - 1) * 4;
+				int x1 = std::min(x * 2 + 1, width - 1) * 4;
+				AverageBlock(row0 + x0, row0 + x1, row1 + x0, row1 + x1, out + x * 4);
+			}
+		}
+
+		levels.push_back(std::move(level));
+		source = levels.back().pixels.data();
+		width = levels.back().width;
+		height = levels.back().height;
+	}
+}
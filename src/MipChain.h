@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief A level of a mip chain.
+ */
+struct MipLevel
+{
+	int width;							///< Width of the level.
+	int height;							///< Height of the level.
+	std::vector<unsigned char> pixels;	///< RGBA pixels of the level.
+};
+
+/**
+ * @brief Builds mip chains of RGBA images on the CPU.
+ *
+ * Each level averages 2x2 blocks of the level above with SSE2. Colors are weighted by
+ * their alpha, as if the image was premultiplied, so transparent pixels do not darken
+ * the edges of sprites. The result keeps straight alpha.
+ */
+namespace MipChain
+{
+	/**
+	 * @brief Gets the number of levels of a full chain.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @return The number of levels down to 1x1, including the image itself.
+	 */
+	int GetLevelCount(int width, int height);
+
+	/**
+	 * @brief Builds the levels below an image, down to 1x1.
+	 * @param pixels The RGBA pixels of the image.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @param levels Receives level 1 and smaller, level 0 is the image itself.
+	 */
+	void Build(const unsigned char* pixels, int width, int height, std::vector<MipLevel>& levels);
+}
\ No newline at end of file
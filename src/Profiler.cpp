@@ -0,0 +1,293 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <fstream>
+#include <thread>
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+
+#include "Logger.h"
+
+// zones opened on this thread and not closed yet
+struct OpenZone
+{
+	const char* name;
+	double startMicro;
+};
+static thread_local std::vector<OpenZone> t_openZones;
+static thread_local int t_threadIndex = -1;
+static std::atomic<int> s_nextThreadIndex{ 1 };
+static std::thread::id s_mainThreadId;
+
+static int GetThreadIndex()
+{
+	if (t_threadIndex < 0)
+	{
+		t_threadIndex = std::this_thread::get_id() == s_mainThreadId ? 0 : s_nextThreadIndex.fetch_add(1);
+	}
+	return t_threadIndex;
+}
+
+static ImU32 GetZoneColor(const char* name)
+{
+	// stable color per zone name
+	unsigned int hash = 2166136261u;
+	for (const char* c = name; *c; c++)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+	}
+	float hue = (hash % 360) / 360.f;
+	return ImColor::HSV(hue, 0.45f, 0.75f);
+}
+
+Profiler::Profiler()
+{
+	s_mainThreadId = std::this_thread::get_id();
+	m_startTime = std::chrono::steady_clock::now();
+	m_frames.resize(FRAME_HISTORY);
+	m_nextFrameSlot = 0;
+	m_frameCount = 0;
+	m_frameIndex = 0;
+	m_paused = false;
+	m_selectedFrame = 0;
+}
+
+void Profiler::BeginFrame()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_currentFrame.frameIndex = m_frameIndex;
+	m_currentFrame.startMicro = Now();
+	m_currentFrame.zones.clear();
+}
+
+void Profiler::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_currentFrame.endMicro = Now();
+	m_frameIndex++;
+
+	if (m_paused)
+	{
+		return;
+	}
+
+	// swap into the ring so the zone storage of the old slot is reused
+	std::swap(m_frames[m_nextFrameSlot], m_currentFrame);
+	m_nextFrameSlot = (m_nextFrameSlot + 1) % FRAME_HISTORY;
+	m_frameCount = std::min(m_frameCount + 1, FRAME_HISTORY);
+}
+
+void Profiler::BeginZone(const char* name)
+{
+	t_openZones.push_back({ name, Now() });
+}
+
+void Profiler::EndZone()
+{
+	if (t_openZones.empty())
+	{
+		return;
+	}
+
+	OpenZone zone = t_openZones.back();
+	t_openZones.pop_back();
+
+	ProfileZone record;
+	record.name = zone.name;
+	record.startMicro = zone.startMicro;
+	record.endMicro = Now();
+	record.depth = static_cast<int>(t_openZones.size());
+	record.threadIndex = GetThreadIndex();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_currentFrame.zones.push_back(record);
+}
+
+void Profiler::SetPaused(bool paused)
+{
+	m_paused = paused;
+}
+
+bool Profiler::IsPaused() const
+{
+	return m_paused;
+}
+
+const ProfileFrame* Profiler::GetFrame(size_t framesAgo) const
+{
+	if (framesAgo >= m_frameCount)
+	{
+		return nullptr;
+	}
+	size_t slot = (m_nextFrameSlot + FRAME_HISTORY - 1 - framesAgo) % FRAME_HISTORY;
+	return &m_frames[slot];
+}
+
+void Profiler::DrawImGui(bool* open)
+{
+	if (!ImGui::Begin("Profiler", open))
+	{
+		ImGui::End();
+		return;
+	}
+
+#if !defined(GS_PROFILER_ENABLED)
+	ImGui::TextUnformatted("Profiling markers are compiled out. Build in Debug or define GS_ENABLE_PROFILER.");
+#endif
+
+	ImGui::Checkbox("Pause", &m_paused);
+	ImGui::SameLine();
+	if (ImGui::Button("Export Chrome trace"))
+	{
+		ExportChromeTrace("profile_trace.json");
+	}
+
+	// frame time history, the newest frame is on the right
+	int count = static_cast<int>(m_frameCount);
+	std::vector<float> history(count);
+	for (int i = 0; i < count; i++)
+	{
+		const ProfileFrame* frame = GetFrame(count - 1 - i);
+		history[i] = static_cast<float>((frame->endMicro - frame->startMicro) / 1000.0);
+	}
+	ImGui::PlotHistogram("##frametimes", history.data(), count, 0, "frame time (ms), click to select", 0.f, FLT_MAX, ImVec2(-1.f, 60.f));
+	if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left) && count > 0)
+	{
+		ImVec2 min = ImGui::GetItemRectMin();
+		ImVec2 max = ImGui::GetItemRectMax();
+		int index = static_cast<int>((ImGui::GetIO().MousePos.x - min.x) / (max.x - min.x) * count);
+		m_selectedFrame = count - 1 - std::clamp(index, 0, count - 1);
+	}
+	ImGui::SliderInt("Frame", &m_selectedFrame, 0, std::max(count - 1, 0), "%d frames ago");
+
+	const ProfileFrame* frame = GetFrame(static_cast<size_t>(m_selectedFrame));
+	if (!frame)
+	{
+		ImGui::End();
+		return;
+	}
+
+	double frameDuration = std::max(frame->endMicro - frame->startMicro, 1.0);
+	ImGui::Text("Frame %llu: %.3f ms, %d zones", frame->frameIndex, frameDuration / 1000.0, static_cast<int>(frame->zones.size()));
+
+	// one band per thread, one row per nesting level
+	int threadCount = 0;
+	for (const auto& zone : frame->zones)
+	{
+		threadCount = std::max(threadCount, zone.threadIndex + 1);
+	}
+	std::vector<int> maxDepth(threadCount, -1);
+	for (const auto& zone : frame->zones)
+	{
+		maxDepth[zone.threadIndex] = std::max(maxDepth[zone.threadIndex], zone.depth);
+	}
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	float width = std::max(ImGui::GetContentRegionAvail().x, 1.f);
+	float rowHeight = ImGui::GetTextLineHeight() + 4.f;
+	float bandTop = origin.y;
+
+	for (int thread = 0; thread < threadCount; thread++)
+	{
+		if (maxDepth[thread] < 0)
+		{
+			continue;
+		}
+
+		for (const auto& zone : frame->zones)
+		{
+			if (zone.threadIndex != thread)
+			{
+				continue;
+			}
+
+			float x0 = origin.x + static_cast<float>((zone.startMicro - frame->startMicro) / frameDuration) * width;
+			float x1 = origin.x + static_cast<float>((zone.endMicro - frame->startMicro) / frameDuration) * width;
+			x0 = std::clamp(x0, origin.x, origin.x + width);
+			x1 = std::clamp(std::max(x1, x0 + 1.f), origin.x, origin.x + width);
+			float y0 = bandTop + zone.depth * rowHeight;
+			ImVec2 min(x0, y0);
+			ImVec2 max(x1, y0 + rowHeight - 1.f);
+
+			drawList->AddRectFilled(min, max, GetZoneColor(zone.name));
+			if (x1 - x0 > ImGui::CalcTextSize(zone.name).x + 4.f)
+			{
+				drawList->AddText(ImVec2(x0 + 2.f, y0 + 2.f), IM_COL32(0, 0, 0, 255), zone.name);
+			}
+			if (ImGui::IsMouseHoveringRect(min, max))
+			{
+				ImGui::SetTooltip("%s\n%.3f ms (thread %d)", zone.name, (zone.endMicro - zone.startMicro) / 1000.0, thread);
+			}
+		}
+		bandTop += (maxDepth[thread] + 1) * rowHeight + 6.f;
+	}
+
+	ImGui::Dummy(ImVec2(width, bandTop - origin.y));
+	ImGui::End();
+}
+
+bool Profiler::ExportChromeTrace(const std::string& filePath) const
+{
+	nlohmann::json events = nlohmann::json::array();
+
+	// oldest frame first
+	for (size_t i = m_frameCount; i-- > 0;)
+	{
+		const ProfileFrame* frame = GetFrame(i);
+
+		events.push_back({
+			{ "name", "Frame " + std::to_string(frame->frameIndex) },
+			{ "cat", "frame" },
+			{ "ph", "X" },
+			{ "ts", frame->startMicro },
+			{ "dur", frame->endMicro - frame->startMicro },
+			{ "pid", 0 },
+			{ "tid", 0 }
+			});
+
+		for (const auto& zone : frame->zones)
+		{
+			events.push_back({
+				{ "name", zone.name },
+				{ "cat", "cpu" },
+				{ "ph", "X" },
+				{ "ts", zone.startMicro },
+				{ "dur", zone.endMicro - zone.startMicro },
+				{ "pid", 0 },
+				{ "tid", zone.threadIndex }
+				});
+		}
+	}
+
+	nlohmann::json trace;
+	trace["traceEvents"] = std::move(events);
+	trace["displayTimeUnit"] = "ms";
+
+	std::ofstream file(filePath);
+	if (!file.is_open())
+	{
+		LogError("Failed to write profiler trace to %s", filePath.c_str());
+		return false;
+	}
+	file << trace.dump();
+	LogInfo("Profiler trace written to %s", filePath.c_str());
+	return true;
+}
+
+double Profiler::Now() const
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+ProfileScope::ProfileScope(const char* name)
+{
+	PROFILER()->BeginZone(name);
+}
+
+ProfileScope::~ProfileScope()
+{
+	PROFILER()->EndZone();
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "SingletonDclp.h"
+
+// profiling markers are only compiled into debug builds, define GS_ENABLE_PROFILER to keep them in release
+#if defined(_DEBUG) || defined(GS_ENABLE_PROFILER)
+#define GS_PROFILER_ENABLED 1
+#endif
+
+/**
+ * @struct ProfileZone
+ * @brief A timed section of code recorded during a frame.
+ */
+struct ProfileZone
+{
+	const char* name;		///< Name of the zone, must be a string literal.
+	double startMicro;		///< Start time in microseconds since the profiler was created.
+	double endMicro;		///< End time in microseconds since the profiler was created.
+	int depth;				///< Nesting level inside the thread, 0 is a root zone.
+	int threadIndex;		///< Index of the thread that recorded the zone, 0 is the main thread.
+};
+
+/**
+ * @struct ProfileFrame
+ * @brief All zones recorded between two frame boundaries.
+ */
+struct ProfileFrame
+{
+	unsigned long long frameIndex = 0;		///< Index of the frame since the game started.
+	double startMicro = 0.0;				///< Start time of the frame in microseconds.
+	double endMicro = 0.0;					///< End time of the frame in microseconds.
+	std::vector<ProfileZone> zones;			///< Zones recorded in the frame, children come before their parents.
+};
+
+/**
+ * @class Profiler
+ * @brief Hierarchical CPU profiler recording scoped markers into a ring buffer of frames.
+ *
+ * Markers are placed with the PROFILE_SCOPE macro, which compiles to nothing in release builds.
+ * The recorded frames can be inspected in an ImGui flame graph or exported as a Chrome trace
+ * (open it in chrome://tracing or https://ui.perfetto.dev).
+ */
+class Profiler final : public SingletonDclp<Profiler>
+{
+public:
+	static constexpr size_t FRAME_HISTORY = 300;	///< Number of frames kept in the ring buffer.
+
+	Profiler();
+
+	/**
+	 * @brief Marks the start of a new frame. Called by Game at the start of every loop iteration.
+	 */
+	void BeginFrame();
+
+	/**
+	 * @brief Closes the current frame and stores it in the ring buffer.
+	 */
+	void EndFrame();
+
+	/**
+	 * @brief Opens a zone on the calling thread. Prefer the PROFILE_SCOPE macro.
+	 * @param name Name of the zone, must outlive the profiler (string literal).
+	 */
+	void BeginZone(const char* name);
+
+	/**
+	 * @brief Closes the innermost zone opened on the calling thread.
+	 */
+	void EndZone();
+
+	/**
+	 * @brief Stops or resumes recording new frames, so a captured spike can be inspected.
+	 * @param paused True to freeze the ring buffer.
+	 */
+	void SetPaused(bool paused);
+
+	/**
+	 * @brief Checks if recording is paused.
+	 * @return True if new frames are discarded.
+	 */
+	bool IsPaused() const;
+
+	/**
+	 * @brief Gets a recorded frame.
+	 * @param framesAgo 0 for the latest completed frame, 1 for the one before, etc.
+	 * @return Pointer to the frame or nullptr if it is not in the history.
+	 */
+	const ProfileFrame* GetFrame(size_t framesAgo) const;
+
+	/**
+	 * @brief Draws the profiler window with the frame time history and the flame graph of the selected frame.
+	 * @param open Pointer to the visibility flag of the window, set to false when it is closed.
+	 */
+	void DrawImGui(bool* open = nullptr);
+
+	/**
+	 * @brief Writes every recorded frame to a Chrome trace event JSON file.
+	 * @param filePath Path of the file to write.
+	 * @return True if the file was written.
+	 */
+	bool ExportChromeTrace(const std::string& filePath) const;
+
+private:
+	std::chrono::steady_clock::time_point m_startTime;		///< Time origin of all timestamps.
+	std::vector<ProfileFrame> m_frames;						///< Ring buffer of completed frames.
+	size_t m_nextFrameSlot;									///< Slot the next completed frame goes into.
+	size_t m_frameCount;									///< Number of valid frames in the ring buffer.
+	ProfileFrame m_currentFrame;							///< Frame being recorded.
+	unsigned long long m_frameIndex;						///< Index of the frame being recorded.
+	mutable std::mutex m_mutex;								///< Guards the current frame, zones may come from worker threads.
+	bool m_paused;											///< Discards new frames when true.
+	int m_selectedFrame;									///< Frame shown in the flame graph, in frames ago.
+
+	/**
+	 * @brief Gets the time elapsed since the profiler was created.
+	 * @return Microseconds since creation.
+	 */
+	double Now() const;
+};
+
+/**
+ * @class ProfileScope
+ * @brief Opens a profiler zone on construction and closes it on destruction.
+ */
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name);
+	~ProfileScope();
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+/**
+ * @def PROFILER
+ * @brief Macro to get the singleton instance of the Profiler.
+ */
+#define PROFILER() Profiler::GetInstance()
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(GS_PROFILER_ENABLED)
+/**
+ * @def PROFILE_SCOPE
+ * @brief Records the time spent until the end of the enclosing scope.
+ */
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -6,6 +6,7 @@
 #include "Logger.h"
 #include "Game.h"
 #include "ResourceManager.h"
+#include "Profiler.h"
 
 Renderer::Renderer(const std::shared_ptr<Camera> camera, const std::shared_ptr<Shader> shader) : 
 	m_camera(camera), m_shader(shader)
@@ -75,6 +76,8 @@ void Renderer::ClearRenderer()
 
 void Renderer::Render(bool frustumCulling)
 {
+	PROFILE_SCOPE("Renderer::Render");
+
 	if (m_camera->needCalculateViewMatrix)
 	{
 		m_camera->CalculateViewMatrix();
@@ -87,6 +90,9 @@ void Renderer::Render(bool frustumCulling)
 
 	OrthoFrustum cameraFrustum = m_camera->GetCameraFrustum();
 
+	// blend factor between the last two simulation steps
+	float alpha = GAME()->GetInterpolationAlpha();
+
 	while (!m_RenderObjects.empty())
 	{
 		auto& obj = m_RenderObjects.front();
@@ -123,10 +129,17 @@ void Renderer::Render(bool frustumCulling)
 		GLuint VAOid = obj->m_mesh->GetVAOId();
 		glBindVertexArray(VAOid);
 
-		if (lastTexture != obj->m_texture)
+		// atlas images on the same page share one bind
+		std::shared_ptr<Texture> boundTexture = obj->m_texture->GetAtlasPage();
+		if (!boundTexture)
+		{
+			boundTexture = obj->m_texture;
+		}
+		if (lastTexture != boundTexture)
 		{
 			// bind texture
 			obj->m_texture->Bind();
+			lastTexture = boundTexture;
 		}
 
 		// send WVP matrix uniform data
@@ -135,18 +148,44 @@ void Renderer::Render(bool frustumCulling)
 		{
 			// get the world matrix
 			// and perform calculating MVP matrix on CPU side
-			auto worldMatrix = obj->GetWorldMatrix();
+			auto worldMatrix = obj->GetInterpolatedWorldMatrix(alpha);
 			auto viewMatrix = m_camera->GetViewMatrix();
 			auto projectionMatrix = m_camera->GetProjectionMatrix();
 			worldMatrix = projectionMatrix * viewMatrix * worldMatrix;
 			glUniformMatrix4fv(uniformLocs["u_mvpMatrix"], 1, GL_FALSE, &worldMatrix[0][0]);
 		}
 
+		// part of the bound texture covered by the object's image
+		if (uniformLocs["u_uvRect"] != -1)
+		{
+			glUniform4fv(uniformLocs["u_uvRect"], 1, &obj->m_texture->GetUVRect()[0]);
+		}
+
+		// untinted unless the object sets its own color
+		if (uniformLocs["u_color"] != -1)
+		{
+			glUniform4f(uniformLocs["u_color"], 1.f, 1.f, 1.f, 1.f);
+		}
+
 		// let object send other uniform data
 		obj->SendUniformData(uniformLocs);
 
-		// Draw	
-		glDrawElements(GL_TRIANGLES, obj->m_mesh->GetNumIndices(), GL_UNSIGNED_INT, 0);
+		// Draw, one call per run of a mesh split over several textures
+		const auto& ranges = obj->m_mesh->m_ranges;
+		if (ranges.empty())
+		{
+			glDrawElements(GL_TRIANGLES, obj->m_mesh->GetNumIndices(), GL_UNSIGNED_INT, 0);
+			continue;
+		}
+		for (const auto& range : ranges)
+		{
+			if (lastTexture != range.texture)
+			{
+				range.texture->Bind();
+				lastTexture = range.texture;
+			}
+			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT, (void*)(range.firstIndex * sizeof(GLuint)));
+		}
 	}
 
 	glBindVertexArray(0);
@@ -173,3 +212,11 @@ AnimationRenderer::AnimationRenderer()
 	m_shader = RESOURCE()->GetShader("animation");
 	m_rendererType = "animation_renderer";
 }
+
+TextRenderer::TextRenderer()
+{
+	m_camera = std::make_shared<Camera>();
+	m_camera->SetOrthographicProjection(0.f, (float)GAME()->GetWindowWidth(), 0.f, (float)GAME()->GetWindowHeight());
+	m_shader = RESOURCE()->GetShader("text_sdf");
+	m_rendererType = "text_renderer";
+}
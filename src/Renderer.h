@@ -121,3 +121,19 @@ public:
 	AnimationRenderer();
 };
 
+/**
+ * @class TextRenderer
+ * @brief Specialized renderer for distance field text.
+ *
+ * Inherits from Renderer and draws Text created with distanceField set, which SpriteRenderer
+ * would show as blurred distance fields.
+ */
+class TextRenderer : public Renderer
+{
+public:
+	/**
+	 * @brief Constructs a TextRenderer.
+	 */
+	TextRenderer();
+};
+
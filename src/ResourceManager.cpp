@@ -1,14 +1,53 @@
 #include "ResourceManager.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <glad/glad.h>
+#include <nlohmann/json.hpp>
+
 #include "Mesh.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "MipChain.h"
+#include "TextureCache.h"
 #include "Config.h"
 #include "Sound.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "Game.h"
+#include "GlyphCache.h"
+#include "stb_image.h"
+
+#include <soloud/soloud_wav.h>
+
+/**
+ * @brief Pixels of an image decoded by a worker.
+ */
+struct DecodedImage
+{
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    std::vector<MipLevel> mips;
+
+    ~DecodedImage()
+    {
+        stbi_image_free(pixels);
+    }
+};
+
+ResourceManager::ResourceManager()
+{
+    m_textureUploadBudget = 4 * 1024 * 1024;
+    m_uploadPBO = 0;
+    m_textureMemoryBudget = 0;
+}
 
 void ResourceManager::LoadMesh(const std::string& name)
 {
+    PROFILE_SCOPE("ResourceManager::LoadMesh");
+
     std::string path = ResourcesPath::MESH + name;
     if (m_MeshList.count(name) == 0)
     {
@@ -22,6 +61,8 @@ void ResourceManager::LoadMesh(const std::string& name)
 
 void ResourceManager::LoadShader(const std::string& name)
 {
+    PROFILE_SCOPE("ResourceManager::LoadShader");
+
     std::string path_vert = ResourcesPath::SHADER + name + ".vert";
     std::string path_frag = ResourcesPath::SHADER + name + ".frag";
 
@@ -34,17 +75,519 @@ void ResourceManager::LoadShader(const std::string& name)
 
 void ResourceManager::LoadTexture(const std::string& name)
 {
+    LoadTexture(name, TextureFilterMode::NEAREST);
+}
+
+void ResourceManager::LoadTexture(const std::string& name, TextureFilterMode mode)
+{
+    PROFILE_SCOPE("ResourceManager::LoadTexture");
+
     std::string path = ResourcesPath::TEXTURE + name;
 
     if (m_TextureList.count(name) == 0)
     {
-        std::shared_ptr<Texture> texture = std::make_shared<Texture>(path);
+        std::shared_ptr<Texture> texture = std::make_shared<Texture>(path, mode);
         m_TextureList[name] = texture;
     }
 }
 
+std::shared_ptr<Texture> ResourceManager::LoadAtlasTexture(const std::string& name)
+{
+    PROFILE_SCOPE("ResourceManager::LoadAtlasTexture");
+
+    auto it = m_TextureList.find(name);
+    if (it != m_TextureList.end())
+    {
+        return it->second;
+    }
+
+    std::string path = ResourcesPath::TEXTURE + name;
+    std::shared_ptr<Texture> texture = m_textureAtlas.Add(name, path);
+    if (!texture)
+    {
+        // too large for a page, fall back to its own texture
+        texture = std::make_shared<Texture>(path);
+        if (!texture->IsReady())
+        {
+            return nullptr;
+        }
+    }
+    m_TextureList[name] = texture;
+    return texture;
+}
+
+TextureAtlas* ResourceManager::GetTextureAtlas()
+{
+    return &m_textureAtlas;
+}
+
+bool ResourceManager::LoadAtlas(const std::string& name)
+{
+    PROFILE_SCOPE("ResourceManager::LoadAtlas");
+
+    if (m_AtlasList.count(name))
+    {
+        return true;
+    }
+
+    std::string path = ResourcesPath::TEXTURE + name;
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        LogError("Failed to open atlas %s", name.c_str());
+        return false;
+    }
+
+    // every value is type checked before it is read, get throws on a mismatch
+    nlohmann::json manifest = nlohmann::json::parse(file, nullptr, false);
+    if (manifest.is_discarded() || !manifest.is_object() || !manifest.contains("pages") || !manifest["pages"].is_array()
+        || !manifest.contains("frames") || !manifest["frames"].is_object())
+    {
+        LogError("Invalid atlas manifest %s", name.c_str());
+        return false;
+    }
+
+    // the pages are next to the manifest
+    std::string folder = name.substr(0, name.find_last_of("/\\") + 1);
+    AtlasContents contents;
+    std::vector<std::shared_ptr<Texture>> pages;
+    for (const auto& page : manifest["pages"])
+    {
+        auto pageFile = page.is_object() ? page.find("file") : page.end();
+        std::string pageName = pageFile != page.end() && pageFile->is_string() ? folder + pageFile->get<std::string>() : "";
+        bool loaded = !pageName.empty() && m_TextureList.count(pageName);
+        std::shared_ptr<Texture> texture;
+        if (!pageName.empty())
+        {
+            LoadTexture(pageName);
+            texture = GetTexture(pageName);
+        }
+        if (!texture || !texture->IsReady())
+        {
+            LogError("Failed to load page %s of atlas %s", pageName.c_str(), name.c_str());
+            for (const auto& loadedPage : contents.pages)
+            {
+                FreeTexture(loadedPage);
+            }
+            if (!pageName.empty() && !loaded)
+            {
+                FreeTexture(pageName);
+            }
+            return false;
+        }
+        pages.push_back(texture);
+        // a page loaded before the atlas is not freed with it
+        if (!loaded)
+        {
+            contents.pages.push_back(pageName);
+        }
+    }
+
+    auto readVec2 = [](const nlohmann::json& data, const char* key, const glm::vec2& fallback)
+        {
+            auto it = data.find(key);
+            if (it == data.end() || !it->is_array() || it->size() != 2 || !(*it)[0].is_number() || !(*it)[1].is_number())
+            {
+                return fallback;
+            }
+            return glm::vec2((*it)[0].get<float>(), (*it)[1].get<float>());
+        };
+
+    for (const auto& item : manifest["frames"].items())
+    {
+        const nlohmann::json& data = item.value();
+        auto pageValue = data.is_object() ? data.find("page") : data.end();
+        auto rect = data.is_object() ? data.find("rect") : data.end();
+        int pageIndex = pageValue != data.end() && pageValue->is_number_integer() ? pageValue->get<int>() : -1;
+        if (pageIndex < 0 || pageIndex >= static_cast<int>(pages.size()) || rect == data.end() || !rect->is_array() || rect->size() != 4
+            || !std::all_of(rect->begin(), rect->end(), [](const nlohmann::json& value) { return value.is_number(); }))
+        {
+            LogWarning("Skipping invalid frame %s of atlas %s", item.key().c_str(), name.c_str());
+            continue;
+        }
+
+        // the frames share the texture names, a name already used is kept as it is
+        if (m_TextureList.count(item.key()) || m_SpriteFrameList.count(item.key()))
+        {
+            LogWarning("Skipping frame %s of atlas %s, a texture or frame has the same name", item.key().c_str(), name.c_str());
+            continue;
+        }
+
+        // the frame binds its page and samples only its rect
+        const std::shared_ptr<Texture>& page = pages[pageIndex];
+        float x = (*rect)[0].get<float>();
+        float y = (*rect)[1].get<float>();
+        float width = (*rect)[2].get<float>();
+        float height = (*rect)[3].get<float>();
+        std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+        texture->m_width = static_cast<int>(width);
+        texture->m_height = static_cast<int>(height);
+        texture->m_atlasPage = page;
+        texture->m_uvRect = glm::vec4(x / page->GetWidth(), y / page->GetHeight(),
+            (x + width) / page->GetWidth(), (y + height) / page->GetHeight());
+
+        SpriteFrame frame;
+        frame.texture = texture;
+        frame.size = glm::vec2(width, height);
+        frame.sourceSize = readVec2(data, "source", frame.size);
+        frame.offset = readVec2(data, "offset", glm::vec2(0.f));
+        frame.pivot = readVec2(data, "pivot", glm::vec2(0.5f));
+
+        m_TextureList[item.key()] = texture;
+        m_SpriteFrameList[item.key()] = frame;
+        contents.frames.push_back(item.key());
+    }
+
+    if (manifest.contains("animations") && manifest["animations"].is_object())
+    {
+        for (const auto& item : manifest["animations"].items())
+        {
+            if (m_SequenceList.count(item.key()))
+            {
+                LogWarning("Skipping animation %s of atlas %s, an animation has the same name", item.key().c_str(), name.c_str());
+                continue;
+            }
+
+            const nlohmann::json& data = item.value();
+            auto frameTime = data.is_object() ? data.find("frameTime") : data.end();
+            auto frameNames = data.is_object() ? data.find("frames") : data.end();
+            std::shared_ptr<SpriteSequence> sequence = std::make_shared<SpriteSequence>();
+            sequence->frameTime = frameTime != data.end() && frameTime->is_number() ? frameTime->get<float>() : 0.1f;
+            if (frameNames != data.end() && frameNames->is_array())
+            {
+                // only the frames of this atlas, a skipped frame leaves its animation shorter
+                for (const auto& frameName : *frameNames)
+                {
+                    auto frame = frameName.is_string() ? m_SpriteFrameList.find(frameName.get<std::string>()) : m_SpriteFrameList.end();
+                    if (frame != m_SpriteFrameList.end()
+                        && std::find(contents.frames.begin(), contents.frames.end(), frame->first) != contents.frames.end())
+                    {
+                        sequence->frames.push_back(frame->second);
+                    }
+                }
+            }
+
+            if (sequence->frames.empty())
+            {
+                LogWarning("Skipping empty animation %s of atlas %s", item.key().c_str(), name.c_str());
+                continue;
+            }
+            m_SequenceList[item.key()] = sequence;
+            contents.sequences.push_back(item.key());
+        }
+    }
+
+    m_AtlasList[name] = contents;
+    return true;
+}
+
+std::shared_ptr<Texture> ResourceManager::LoadTextureAsync(const std::string& name)
+{
+    return LoadTextureAsync(name, TextureFilterMode::NEAREST);
+}
+
+std::shared_ptr<Texture> ResourceManager::LoadTextureAsync(const std::string& name, TextureFilterMode mode)
+{
+    PROFILE_SCOPE("ResourceManager::LoadTextureAsync");
+
+    auto it = m_TextureList.find(name);
+    if (it != m_TextureList.end())
+    {
+        return it->second;
+    }
+
+    // the texture is handed out right away and binds the placeholder until ready
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+    texture->m_ready = false;
+    texture->m_filterMode = mode;
+    m_TextureList[name] = texture;
+
+    QueueTextureDecode(name, texture);
+    return texture;
+}
+
+void ResourceManager::QueueTextureDecode(const std::string& name, const std::shared_ptr<Texture>& texture)
+{
+    PendingTexture pending;
+    pending.name = name;
+    pending.texture = texture;
+    pending.image = std::make_shared<DecodedImage>();
+    pending.uploadedRows = 0;
+
+    // decode on a worker, always as RGBA so rows need no unpack alignment
+    std::string path = ResourcesPath::TEXTURE + name;
+    std::shared_ptr<DecodedImage> image = pending.image;
+    bool mipmapped = texture->m_filterMode == TextureFilterMode::MIPMAP;
+    pending.decodeJob = JOBS()->Run([path, image, mipmapped]()
+        {
+            bool cached = TextureCache::Read(path, [&image](int level, int width, int height, const unsigned char* pixels)
+                {
+                    size_t size = static_cast<size_t>(width) * height * 4;
+                    if (level > 0)
+                    {
+                        image->mips.push_back({ width, height, std::vector<unsigned char>(pixels, pixels + size) });
+                        return;
+                    }
+
+                    // stbi_image_free is free(), so the cached pixels are copied into a malloc block
+                    image->pixels = static_cast<unsigned char*>(malloc(size));
+                    memcpy(image->pixels, pixels, size);
+                    image->width = width;
+                    image->height = height;
+                }, mipmapped ? 32 : 1);
+            if (cached)
+            {
+                return;
+            }
+            // drop what a corrupted entry left
+            stbi_image_free(image->pixels);
+            image->mips.clear();
+
+            // the chain is built here for the cache even when the texture does not use it
+            int channels = 0;
+            image->pixels = stbi_load(path.c_str(), &image->width, &image->height, &channels, STBI_rgb_alpha);
+            if (image->pixels)
+            {
+                MipChain::Build(image->pixels, image->width, image->height, image->mips);
+                TextureCache::Write(path, image->pixels, image->width, image->height, image->mips);
+                if (!mipmapped)
+                {
+                    image->mips.clear();
+                }
+            }
+        });
+
+    m_pendingTextures.push_back(pending);
+}
+
+void ResourceManager::Update()
+{
+    PROFILE_SCOPE("ResourceManager::Update");
+
+    // decoded sounds are published before the next play
+    for (size_t i = 0; i < m_pendingSounds.size();)
+    {
+        PendingSound& pending = m_pendingSounds[i];
+        if (!pending.decodeJob->IsDone())
+        {
+            i++;
+            continue;
+        }
+
+        PublishPendingSound(pending);
+        m_pendingSounds.erase(m_pendingSounds.begin() + i);
+    }
+
+    // binds from now on belong to the new frame
+    Texture::s_frame++;
+    ReloadEvictedTextures();
+    EnforceTextureBudget();
+
+    size_t budget = m_textureUploadBudget;
+    for (size_t i = 0; i < m_pendingTextures.size() && budget > 0;)
+    {
+        PendingTexture& pending = m_pendingTextures[i];
+        if (!pending.decodeJob->IsDone())
+        {
+            i++;
+            continue;
+        }
+
+        if (UploadPendingTexture(pending, budget))
+        {
+            m_pendingTextures.erase(m_pendingTextures.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void ResourceManager::SetTextureMemoryBudget(size_t bytes)
+{
+    m_textureMemoryBudget = bytes;
+}
+
+size_t ResourceManager::GetTextureMemoryUsage() const
+{
+    size_t usage = 0;
+    for (const auto& it : m_TextureList)
+    {
+        usage += it.second->GetMemorySize();
+    }
+    return usage;
+}
+
+size_t ResourceManager::GetEvictedTextureCount() const
+{
+    return m_evictedTextures.size();
+}
+
+void ResourceManager::EnforceTextureBudget()
+{
+    if (m_textureMemoryBudget == 0)
+    {
+        return;
+    }
+
+    size_t usage = GetTextureMemoryUsage();
+    if (usage <= m_textureMemoryBudget)
+    {
+        return;
+    }
+
+    PROFILE_SCOPE("ResourceManager::EnforceTextureBudget");
+
+    // textures bound during the last frame are still on screen and are kept
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    for (const auto& it : m_TextureList)
+    {
+        const Texture& texture = *it.second;
+        if (texture.m_ready && texture.GetMemorySize() > 0 && texture.m_lastBindFrame + 1 < Texture::s_frame)
+        {
+            candidates.emplace_back(texture.m_lastBindFrame, it.first);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& candidate : candidates)
+    {
+        if (usage <= m_textureMemoryBudget)
+        {
+            break;
+        }
+
+        Texture& texture = *m_TextureList[candidate.second];
+        usage -= texture.GetMemorySize();
+        texture.Evict();
+        m_evictedTextures[candidate.second] = Texture::s_frame;
+    }
+
+    if (usage > m_textureMemoryBudget)
+    {
+        LogWarning("Textures in use need %zu bytes, over the budget of %zu bytes", usage, m_textureMemoryBudget);
+    }
+}
+
+void ResourceManager::ReloadEvictedTextures()
+{
+    for (auto it = m_evictedTextures.begin(); it != m_evictedTextures.end();)
+    {
+        auto texture = m_TextureList.find(it->first);
+        if (texture == m_TextureList.end())
+        {
+            it = m_evictedTextures.erase(it);
+        }
+        else if (texture->second->m_lastBindFrame >= it->second)
+        {
+            // bound since it was evicted, the cache makes the decode cheap
+            QueueTextureDecode(it->first, texture->second);
+            it = m_evictedTextures.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void ResourceManager::SetTextureUploadBudget(size_t bytesPerFrame)
+{
+    m_textureUploadBudget = bytesPerFrame;
+}
+
+size_t ResourceManager::GetPendingTextureCount() const
+{
+    return m_pendingTextures.size();
+}
+
+void ResourceManager::FinishTextureLoads()
+{
+    PROFILE_SCOPE("ResourceManager::FinishTextureLoads");
+
+    while (!m_pendingTextures.empty())
+    {
+        PendingTexture& pending = m_pendingTextures.front();
+        JOBS()->Wait(pending.decodeJob);
+
+        size_t budget = static_cast<size_t>(-1);
+        while (!UploadPendingTexture(pending, budget))
+        {
+        }
+        m_pendingTextures.erase(m_pendingTextures.begin());
+    }
+}
+
+bool ResourceManager::UploadPendingTexture(PendingTexture& pending, size_t& budget)
+{
+    std::shared_ptr<Texture> texture = pending.texture.lock();
+    if (!texture)
+    {
+        // freed before it finished loading
+        return true;
+    }
+
+    DecodedImage& image = *pending.image;
+    if (!image.pixels)
+    {
+        LogError("Failed to load texture %s", pending.name.c_str());
+        return true;
+    }
+
+    if (pending.uploadedRows == 0)
+    {
+        texture->CreateStorage(image.width, image.height);
+    }
+
+    // at least one row per frame so a small budget still makes progress
+    size_t rowBytes = static_cast<size_t>(image.width) * 4;
+    // clamped before narrowing, an unlimited budget does not fit in an int
+    size_t rowsLeft = static_cast<size_t>(image.height - pending.uploadedRows);
+    int rowCount = static_cast<int>(std::min<size_t>(std::max<size_t>(budget / rowBytes, 1), rowsLeft));
+    size_t size = rowBytes * rowCount;
+    const unsigned char* source = image.pixels + rowBytes * pending.uploadedRows;
+
+    if (m_uploadPBO == 0)
+    {
+        glGenBuffers(1, &m_uploadPBO);
+    }
+
+    // orphan the buffer so the driver does not wait for the previous slice
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadPBO);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped)
+    {
+        std::memcpy(mapped, source, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        texture->UploadRows(pending.uploadedRows, rowCount, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else
+    {
+        // mapping failed, upload straight from memory
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        texture->UploadRows(pending.uploadedRows, rowCount, source);
+    }
+
+    pending.uploadedRows += rowCount;
+    budget -= std::min(budget, size);
+
+    if (pending.uploadedRows < image.height)
+    {
+        return false;
+    }
+
+    texture->FinishUpload(image.mips);
+    pending.image = nullptr;
+    return true;
+}
+
 void ResourceManager::LoadSound(const std::string& name)
 {
+    PROFILE_SCOPE("ResourceManager::LoadSound");
+
     std::string path = ResourcesPath::SOUND + name;
 
     if (m_SoundList.count(name) == 0)
@@ -54,32 +597,140 @@ void ResourceManager::LoadSound(const std::string& name)
     }
 }
 
-void ResourceManager::LoadFont(const std::string& name, int size)
+void ResourceManager::LoadMusic(const std::string& name)
 {
-    std::string path = ResourcesPath::FONT + name;
+    PROFILE_SCOPE("ResourceManager::LoadMusic");
 
-    auto findFont = [&](const std::string& name, int size) 
-        {
-        return std::find_if(m_FontList.begin(), m_FontList.end(),
-            [&](const std::tuple<std::string, int, TTF_Font*>& font) 
-            {
-                return std::get<0>(font) == name && std::get<1>(font) == size;
-            });
-        };
+    std::string path = ResourcesPath::SOUND + name;
+
+    if (m_SoundList.count(name) == 0)
+    {
+        std::shared_ptr<Sound> sound = std::make_shared<Sound>(path, true);
+        m_SoundList[name] = sound;
+    }
+}
 
-    auto it = findFont(name, size);
+void ResourceManager::LoadSoundBank(const std::string& bankName, const std::vector<std::string>& names, const SoundBankOptions& options)
+{
+    PROFILE_SCOPE("ResourceManager::LoadSoundBank");
 
-    if (it == m_FontList.end())
+    std::vector<std::string> paths;
+    for (const auto& name : names)
     {
-        TTF_Font* font = TTF_OpenFont(path.c_str(), size);
-        if (!font)
+        paths.push_back(ResourcesPath::SOUND + name);
+    }
+
+    std::string bankPath = SoundBank::GetBankPath(bankName);
+    std::shared_ptr<SoundBank> bank = SoundBank::Open(bankPath, paths, options);
+    if (!bank && SoundBank::Write(bankPath, paths, options))
+    {
+        bank = SoundBank::Open(bankPath, paths, options);
+    }
+
+    if (!bank)
+    {
+        LogWarning("Can not use sound bank %s, loading its sounds one by one", bankName.c_str());
+        for (const auto& name : names)
         {
-            LogError("Error loading font %s, %s", name.c_str(), TTF_GetError());
+            LoadSound(name);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (m_SoundList.count(names[i]) == 0)
+        {
+            m_SoundList[names[i]] = std::make_shared<Sound>(bank, i);
         }
-        m_FontList.push_back(std::make_tuple(name, size, font));
     }
 }
 
+std::shared_ptr<Sound> ResourceManager::LoadSoundAsync(const std::string& name)
+{
+    PROFILE_SCOPE("ResourceManager::LoadSoundAsync");
+
+    auto it = m_SoundList.find(name);
+    if (it != m_SoundList.end())
+    {
+        return it->second;
+    }
+
+    // the sound is handed out right away and is not played until ready
+    std::shared_ptr<Sound> sound(new Sound());
+    m_SoundList[name] = sound;
+
+    PendingSound pending;
+    pending.sound = sound;
+    pending.wav = std::make_shared<SoLoud::Wav>();
+
+    // the Wav is not known to the audio engine yet, loading it touches nothing shared
+    std::string path = ResourcesPath::SOUND + name;
+    std::shared_ptr<SoLoud::Wav> wav = pending.wav;
+    pending.name = name;
+    pending.decodeJob = JOBS()->Run([path, wav]()
+        {
+            wav->load(path.c_str());
+        });
+
+    m_pendingSounds.push_back(pending);
+    return sound;
+}
+
+size_t ResourceManager::GetPendingSoundCount() const
+{
+    return m_pendingSounds.size();
+}
+
+void ResourceManager::FinishSoundLoads()
+{
+    PROFILE_SCOPE("ResourceManager::FinishSoundLoads");
+
+    for (auto& pending : m_pendingSounds)
+    {
+        JOBS()->Wait(pending.decodeJob);
+        PublishPendingSound(pending);
+    }
+    m_pendingSounds.clear();
+}
+
+void ResourceManager::PublishPendingSound(PendingSound& pending)
+{
+    if (!pending.wav->mData)
+    {
+        LogWarning("Failed to load sound: %s", pending.name.c_str());
+    }
+
+    // a failed sound is published anyway and plays silence, like LoadSound
+    std::shared_ptr<Sound> sound = pending.sound.lock();
+    if (sound)
+    {
+        sound->FinishLoad(pending.wav);
+    }
+}
+
+size_t ResourceManager::GetSoundMemoryUsage() const
+{
+    size_t usage = 0;
+    for (const auto& it : m_SoundList)
+    {
+        usage += it.second->GetMemorySize();
+    }
+    return usage;
+}
+
+void ResourceManager::LoadFont(const std::string& name, int size)
+{
+    PROFILE_SCOPE("ResourceManager::LoadFont");
+
+    m_fontManager.Load(name, size);
+}
+
+std::shared_ptr<TTF_Font> ResourceManager::AcquireFont(const std::string& name, int size)
+{
+    return m_fontManager.Acquire(name, size);
+}
+
 std::shared_ptr<Mesh> ResourceManager::GetMesh(const std::string& name)
 {
     auto it = m_MeshList.find(name);
@@ -110,6 +761,26 @@ std::shared_ptr<Texture> ResourceManager::GetTexture(const std::string& name)
     return nullptr;
 }
 
+const SpriteFrame* ResourceManager::GetSpriteFrame(const std::string& name)
+{
+    auto it = m_SpriteFrameList.find(name);
+    if (it != m_SpriteFrameList.end())
+    {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<SpriteSequence> ResourceManager::GetSpriteSequence(const std::string& name)
+{
+    auto it = m_SequenceList.find(name);
+    if (it != m_SequenceList.end())
+    {
+        return it->second;
+    }
+    return nullptr;
+}
+
 std::shared_ptr<Sound> ResourceManager::GetSound(const std::string& name)
 {
     auto it = m_SoundList.find(name);
@@ -122,23 +793,12 @@ std::shared_ptr<Sound> ResourceManager::GetSound(const std::string& name)
 
 TTF_Font* ResourceManager::GetFont(const std::string& name, int size)
 {
-    auto findFont = [&](const std::string& name, int size) 
-        {
-        return std::find_if(m_FontList.begin(), m_FontList.end(),
-            [&](const std::tuple<std::string, int, TTF_Font*>& font) 
-            {
-                return std::get<0>(font) == name && std::get<1>(font) == size;
-            });
-        };
-
-    auto it = findFont(name, size);
-
-    if (it != m_FontList.end())
-    {
-        return std::get<2>(*it);
-    }
+    return m_fontManager.Get(name, size);
+}
 
-    return nullptr;
+FontManager* ResourceManager::GetFontManager()
+{
+    return &m_fontManager;
 }
 
 void ResourceManager::FreeMesh(const std::string& name)
@@ -153,68 +813,75 @@ void ResourceManager::FreeShader(const std::string& name)
 
 void ResourceManager::FreeTexture(const std::string& name)
 {
+    auto it = m_TextureList.find(name);
+    if (it != m_TextureList.end() && it->second->GetAtlasPage())
+    {
+        m_textureAtlas.Remove(name);
+    }
     m_TextureList.erase(name);
+    m_evictedTextures.erase(name);
 }
 
-void ResourceManager::FreeSound(const std::string& name)
+void ResourceManager::FreeAtlas(const std::string& name)
 {
-    m_SoundList.erase(name);
-}
+    auto it = m_AtlasList.find(name);
+    if (it == m_AtlasList.end())
+    {
+        return;
+    }
 
-void ResourceManager::FreeFont(const std::string& name, int size)
-{
-    if (!size)
+    for (const auto& sequence : it->second.sequences)
     {
-        DeleteFontByName(name);
+        m_SequenceList.erase(sequence);
     }
-    else
+    for (const auto& frame : it->second.frames)
     {
-        DeleteFontByNameAndSize(name, size);
+        // a frame texture freed and loaded again under its name is no longer the atlas one
+        auto texture = m_TextureList.find(frame);
+        auto spriteFrame = m_SpriteFrameList.find(frame);
+        if (texture != m_TextureList.end() && spriteFrame != m_SpriteFrameList.end() && texture->second == spriteFrame->second.texture)
+        {
+            m_TextureList.erase(texture);
+        }
+        m_SpriteFrameList.erase(frame);
     }
-}
-
-void ResourceManager::FreeAllResources()
-{
-    m_MeshList.clear();
-    m_ShaderList.clear();
-    m_TextureList.clear();
-    m_SoundList.clear();
-    for (auto it = m_FontList.begin(); it != m_FontList.end(); it++)
+    for (const auto& page : it->second.pages)
     {
-        TTF_CloseFont(std::get<2>(*it));
+        m_TextureList.erase(page);
     }
-    m_FontList.clear();
+    m_AtlasList.erase(it);
 }
 
-void ResourceManager::DeleteFontByName(const std::string& name)
+void ResourceManager::FreeSound(const std::string& name)
 {
-    auto it = std::remove_if(m_FontList.begin(), m_FontList.end(),
-        [&](const std::tuple<std::string, int, TTF_Font*>& font) 
-        {
-            if (std::get<0>(font) == name)
-            {
-                TTF_CloseFont(std::get<2>(font)); // Close the font
-                return true;
-            }
-            return false;
-        });
-
-    m_FontList.erase(it, m_FontList.end());
+    m_SoundList.erase(name);
+}
 
+void ResourceManager::FreeFont(const std::string& name, int size)
+{
+    m_fontManager.Free(name, size);
 }
 
-void ResourceManager::DeleteFontByNameAndSize(const std::string& name, int size)
+void ResourceManager::FreeAllResources()
 {
-    auto it = std::remove_if(m_FontList.begin(), m_FontList.end(),
-        [&](const std::tuple<std::string, int, TTF_Font*>& font)
-        {
-            if (std::get<0>(font) == name && std::get<1>(font) == size)
-            {
-                TTF_CloseFont(std::get<2>(font)); // Close the font
-                return true;
-            }
-            return false;
-        });
+    m_pendingTextures.clear();
+    if (m_uploadPBO)
+    {
+        glDeleteBuffers(1, &m_uploadPBO);
+        m_uploadPBO = 0;
+    }
+    Texture::DeletePlaceholder();
 
-    m_FontList.erase(it, m_FontList.end());
+    m_MeshList.clear();
+    m_ShaderList.clear();
+    m_TextureList.clear();
+    m_evictedTextures.clear();
+    m_textureAtlas.Clear();
+    m_SequenceList.clear();
+    m_SpriteFrameList.clear();
+    m_AtlasList.clear();
+    m_pendingSounds.clear();
+    m_SoundList.clear();
+    GlyphCache::ReleaseAll();
+    m_fontManager.Clear();
 }
@@ -8,11 +8,23 @@
 #include <SDL2/SDL_ttf.h>
 
 #include "SingletonDclp.h"
+#include "SpriteSheet.h"
+#include "TextureAtlas.h"
+#include "FontManager.h"
+#include "SoundBank.h"
 
 class Mesh;
 class Shader;
 class Texture;
 class Sound;
+class JobCounter;
+struct DecodedImage;
+enum class TextureFilterMode;
+
+namespace SoLoud
+{
+	class Wav;
+}
 
 /**
  * @class ResourceManager
@@ -23,6 +35,11 @@ class Sound;
 class ResourceManager : public SingletonDclp<ResourceManager>
 {
 public:
+	/**
+	 * @brief Constructs the resource manager with a 4 MiB per frame texture upload budget.
+	 */
+	ResourceManager();
+
 	/**
 	 * @brief Loads a mesh resource from file.
 	 * @param name The name of the mesh resource.
@@ -40,13 +57,118 @@ public:
 	void LoadShader(const std::string& name);
 
 	/**
-	 * @brief Loads a texture resource from file.
+	 * @brief Loads a texture resource from file, with nearest filtering and no mip levels.
 	 * @param name The name of the texture resource.
 	 * 
 	 * Supported file extensions: PNG, TGA, JPG, BMP
 	 */
 	void LoadTexture(const std::string& name);
 
+	/**
+	 * @brief Loads a texture resource from file with a filtering mode.
+	 * @param name The name of the texture resource.
+	 * @param mode The filtering mode. MIPMAP uploads the mip chain kept in the texture cache,
+	 * the other modes upload the image only.
+	 */
+	void LoadTexture(const std::string& name, TextureFilterMode mode);
+
+	/**
+	 * @brief Loads a texture into the shared texture atlas.
+	 * @param name The name of the texture resource.
+	 * @return The texture, or nullptr if the file can not be loaded.
+	 *
+	 * The texture is registered like any other and GetTexture returns it, but it binds an
+	 * atlas page, so sprites using atlas textures on the same page batch into one draw call.
+	 * Meant for small sprites. An image too large for a page is loaded as a normal texture.
+	 */
+	std::shared_ptr<Texture> LoadAtlasTexture(const std::string& name);
+
+	/**
+	 * @brief Gets the atlas used by LoadAtlasTexture.
+	 * @return The texture atlas.
+	 */
+	TextureAtlas* GetTextureAtlas();
+
+	/**
+	 * @brief Loads an atlas prebuilt by the AtlasBuilder tool.
+	 * @param name The name of the JSON manifest, its pages are next to it.
+	 * @return True if the manifest and its pages were loaded.
+	 *
+	 * Every frame is registered as a texture named after its source image, so GetTexture
+	 * returns it, and every animation can be retrieved with GetSpriteSequence. A frame or animation
+	 * whose name is already used, by a texture or another atlas, is skipped with a warning.
+	 */
+	bool LoadAtlas(const std::string& name);
+
+	/**
+	 * @brief Loads a texture in the background.
+	 * @param name The name of the texture resource.
+	 * @return The texture, usable right away. It binds a transparent placeholder until IsReady.
+	 *
+	 * The image is decoded on a job worker, then Update uploads it through a pixel buffer
+	 * in slices of at most the upload budget per frame. Loading a texture that is already
+	 * loaded or loading returns the existing one.
+	 */
+	std::shared_ptr<Texture> LoadTextureAsync(const std::string& name);
+
+	/**
+	 * @brief Loads a texture in the background with a filtering mode.
+	 * @param name The name of the texture resource.
+	 * @param mode The filtering mode. The mip chain of MIPMAP textures is built on the worker.
+	 * @return The texture, usable right away. It binds a transparent placeholder until IsReady.
+	 */
+	std::shared_ptr<Texture> LoadTextureAsync(const std::string& name, TextureFilterMode mode);
+
+	/**
+	 * @brief Uploads the decoded textures, within the upload budget. Called by Game every frame.
+	 *
+	 * Also enforces the texture memory budget, reloads the evicted textures bound again and
+	 * publishes the sounds decoded by LoadSoundAsync.
+	 */
+	void Update();
+
+	/**
+	 * @brief Sets the GPU memory the loaded textures may use.
+	 * @param bytes The budget, 0 for no limit (the default).
+	 *
+	 * Over budget, Update evicts the textures bound least recently, oldest first. Textures
+	 * bound during the last frame are never evicted. An evicted texture stays valid and binds
+	 * the placeholder; once bound again it is reloaded in the background like LoadTextureAsync.
+	 * Atlas pages built at runtime are not counted.
+	 */
+	void SetTextureMemoryBudget(size_t bytes);
+
+	/**
+	 * @brief Gets the GPU memory used by the loaded textures, mip levels included.
+	 * @return The usage in bytes.
+	 */
+	size_t GetTextureMemoryUsage() const;
+
+	/**
+	 * @brief Gets the number of textures evicted and not reloaded yet.
+	 * @return The number of evicted textures.
+	 */
+	size_t GetEvictedTextureCount() const;
+
+	/**
+	 * @brief Sets how many bytes of texture data are uploaded per frame.
+	 * @param bytesPerFrame The budget (at least one row of a texture is uploaded per frame).
+	 */
+	void SetTextureUploadBudget(size_t bytesPerFrame);
+
+	/**
+	 * @brief Gets the number of textures still decoding or uploading.
+	 * @return The number of pending textures.
+	 */
+	size_t GetPendingTextureCount() const;
+
+	/**
+	 * @brief Waits for every pending texture and uploads them regardless of the budget.
+	 *
+	 * Useful at the end of a loading screen.
+	 */
+	void FinishTextureLoads();
+
 	/**
 	 * @brief Loads a sound resource.
 	 * @param name The name of the sound resource.
@@ -56,13 +178,76 @@ public:
 	void LoadSound(const std::string& name);
 
 	/**
-	 * @brief Loads a font resource.
+	 * @brief Loads a sound resource that is streamed from its file while it plays.
+	 * @param name The name of the sound resource.
+	 *
+	 * Meant for music and long ambiences: loading only reads the header and the samples are
+	 * decoded a little at a time, instead of holding minutes of decoded samples in memory.
+	 * Get and play it like any other sound, with GetSound.
+	 * Supported file extensions: WAV, MP3, FLAC, OGG
+	 */
+	void LoadMusic(const std::string& name);
+
+	/**
+	 * @brief Loads many short sounds from a bank of decoded samples.
+	 * @param bankName The name of the bank in the cache folder.
+	 * @param names The names of the sound resources.
+	 * @param options How the sounds are converted when the bank is written.
+	 *
+	 * The bank is written on the first call, or when a sound file changed, and mapped on the
+	 * next ones, so the sounds are neither decoded nor copied. Get and play them like any other
+	 * sound, with GetSound. Falls back to LoadSound if the bank can not be written.
+	 * Supported file extensions: WAV, MP3, FLAC, OGG
+	 */
+	void LoadSoundBank(const std::string& bankName, const std::vector<std::string>& names, const SoundBankOptions& options = SoundBankOptions());
+
+	/**
+	 * @brief Loads a sound resource in the background.
+	 * @param name The name of the sound resource.
+	 * @return The sound, usable right away. It plays once IsReady, see SoundPlayer::Play.
+	 *
+	 * The file is decoded on a job worker and Update publishes the samples. Loading a sound
+	 * that is already loaded or loading returns the existing one.
+	 * Supported file extensions: WAV, MP3, FLAC, OGG
+	 */
+	std::shared_ptr<Sound> LoadSoundAsync(const std::string& name);
+
+	/**
+	 * @brief Gets the number of sounds still decoding.
+	 * @return The number of pending sounds.
+	 */
+	size_t GetPendingSoundCount() const;
+
+	/**
+	 * @brief Waits for every pending sound and publishes them.
+	 *
+	 * Useful at the end of a loading screen.
+	 */
+	void FinishSoundLoads();
+
+	/**
+	 * @brief Gets the memory used by the loaded sounds.
+	 * @return The size of the decoded samples in bytes, streamed sounds hold none.
+	 */
+	size_t GetSoundMemoryUsage() const;
+
+	/**
+	 * @brief Loads a font resource and keeps it open until FreeFont.
 	 * @param name The name of the font resource.
 	 * @param size The size of the font (in pt).
-	 * @note This method is currently unused.
 	 */
 	void LoadFont(const std::string& name, int size);
 
+	/**
+	 * @brief Gets a shared font, opening it on first use.
+	 * @param name The name of the font resource.
+	 * @param size The size of the font (in pt).
+	 * @return The font, closed when the last holder releases it. nullptr if it can not be opened.
+	 *
+	 * Texts constructed from a font path share their font through this.
+	 */
+	std::shared_ptr<TTF_Font> AcquireFont(const std::string& name, int size);
+
 	/**
 	 * @brief Retrieves a loaded mesh resource.
 	 * @param name The name of the mesh resource.
@@ -84,6 +269,20 @@ public:
 	 */
 	std::shared_ptr<Texture> GetTexture(const std::string& name);
 
+	/**
+	 * @brief Retrieves a frame of a loaded atlas with its trim and pivot data.
+	 * @param name The name of the frame.
+	 * @return The frame, or nullptr if no loaded atlas has it.
+	 */
+	const SpriteFrame* GetSpriteFrame(const std::string& name);
+
+	/**
+	 * @brief Retrieves an animation of a loaded atlas.
+	 * @param name The name of the animation.
+	 * @return The animation, or nullptr if no loaded atlas has it.
+	 */
+	std::shared_ptr<SpriteSequence> GetSpriteSequence(const std::string& name);
+
 	/**
 	 * @brief Retrieves a loaded sound resource.
 	 * @param name The name of the sound resource.
@@ -95,11 +294,16 @@ public:
 	 * @brief Retrieves a loaded font resource.
 	 * @param name The name of the font resource.
 	 * @param size The size of the font.
-	 * @return A pointer to the font resource.
-	 * @note This method is currently unused.
+	 * @return A pointer to the font resource, nullptr if it is not open.
 	 */
 	TTF_Font* GetFont(const std::string& name, int size);
 
+	/**
+	 * @brief Gets the font manager, for font metrics and statistics.
+	 * @return The font manager.
+	 */
+	FontManager* GetFontManager();
+
 	/**
 	 * @brief Frees a loaded mesh resource.
 	 * @param name The name of the mesh resource.
@@ -118,6 +322,12 @@ public:
 	 */
 	void FreeTexture(const std::string& name);
 
+	/**
+	 * @brief Frees an atlas with its pages, frames and animations.
+	 * @param name The name of the JSON manifest.
+	 */
+	void FreeAtlas(const std::string& name);
+
 	/**
 	 * @brief Frees a loaded sound resource.
 	 * @param name The name of the sound resource.
@@ -127,8 +337,9 @@ public:
 	/**
 	 * @brief Frees a loaded font resource.
 	 * @param name The name of the font resource.
-	 * @param size The size of the font. Defaults to 0.
-	 * @note This method is currently unused.
+	 * @param size The size of the font. Defaults to 0, which frees every size.
+	 *
+	 * A font still used by a text is closed when the text is destroyed.
 	 */
 	void FreeFont(const std::string& name, int size = 0);
 
@@ -142,11 +353,86 @@ private:
 	std::unordered_map<std::string, std::shared_ptr<Shader>> m_ShaderList;			///< List of loaded shaders.
 	std::unordered_map<std::string, std::shared_ptr<Texture>> m_TextureList;		///< List of loaded textures.
 	std::unordered_map<std::string, std::shared_ptr<Sound>> m_SoundList;			///< List of loaded sounds.
-	std::vector<std::tuple<std::string, int, TTF_Font*>> m_FontList;				///< List of loaded fonts. Currently unused.
+	FontManager m_fontManager;														///< Shared fonts by name and size.
+	TextureAtlas m_textureAtlas;													///< Atlas holding the textures loaded with LoadAtlasTexture.
+	std::unordered_map<std::string, SpriteFrame> m_SpriteFrameList;					///< Frames of the loaded prebuilt atlases.
+	std::unordered_map<std::string, std::shared_ptr<SpriteSequence>> m_SequenceList;	///< Animations of the loaded prebuilt atlases.
+
+	/**
+	 * @brief Resources created from an atlas manifest, freed together.
+	 */
+	struct AtlasContents
+	{
+		std::vector<std::string> pages;		///< Names of the page textures.
+		std::vector<std::string> frames;	///< Names of the frames.
+		std::vector<std::string> sequences;	///< Names of the animations.
+	};
+
+	std::unordered_map<std::string, AtlasContents> m_AtlasList;						///< Loaded prebuilt atlases by manifest name.
+
+	/**
+	 * @brief A texture loaded in the background.
+	 */
+	struct PendingTexture
+	{
+		std::string name;							///< Name of the texture resource.
+		std::weak_ptr<Texture> texture;				///< The texture, the upload is dropped if it is freed.
+		std::shared_ptr<DecodedImage> image;		///< Pixels written by the decode job.
+		std::shared_ptr<JobCounter> decodeJob;		///< Done once the image is decoded.
+		int uploadedRows;							///< Rows already sent to the GPU.
+	};
+
+	std::vector<PendingTexture> m_pendingTextures;	///< Textures decoding or uploading, oldest first.
+	size_t m_textureUploadBudget;					///< Bytes uploaded per frame.
+	unsigned int m_uploadPBO;						///< Pixel buffer used to stream texture rows.
+	size_t m_textureMemoryBudget;					///< GPU bytes the textures may use, 0 for no limit.
+
+	/**
+	 * @brief A sound loaded in the background.
+	 */
+	struct PendingSound
+	{
+		std::string name;							///< Name of the sound resource.
+		std::weak_ptr<Sound> sound;					///< The sound, the samples are dropped if it is freed.
+		std::shared_ptr<SoLoud::Wav> wav;			///< Samples written by the decode job.
+		std::shared_ptr<JobCounter> decodeJob;		///< Done once the file is decoded.
+	};
+
+	std::vector<PendingSound> m_pendingSounds;		///< Sounds decoding, oldest first.
+	std::unordered_map<std::string, uint64_t> m_evictedTextures;	///< Evicted textures by name, with the frame of their eviction.
 
 private:
-	void DeleteFontByName(const std::string& name);
-	void DeleteFontByNameAndSize(const std::string& name, int size);
+	/**
+	 * @brief Uploads rows of a decoded texture.
+	 * @param pending The texture.
+	 * @param budget Bytes left this frame, decreased by what was uploaded.
+	 * @return True when the texture is complete or can not be uploaded.
+	 */
+	bool UploadPendingTexture(PendingTexture& pending, size_t& budget);
+
+	/**
+	 * @brief Starts decoding a texture resource on a worker, Update uploads it.
+	 * @param name The name of the texture resource.
+	 * @param texture The texture receiving the pixels.
+	 */
+	void QueueTextureDecode(const std::string& name, const std::shared_ptr<Texture>& texture);
+
+	/**
+	 * @brief Hands the decoded samples of a sound to it and marks it as ready.
+	 * @param pending The decoded sound.
+	 */
+	void PublishPendingSound(PendingSound& pending);
+
+	/**
+	 * @brief Evicts the least recently bound textures while over the memory budget.
+	 */
+	void EnforceTextureBudget();
+
+	/**
+	 * @brief Reloads the evicted textures bound since their eviction.
+	 */
+	void ReloadEvictedTextures();
+
 };
 
 /**
@@ -6,6 +6,8 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
 	m_uniformNames.push_back("u_mvpMatrix");
 	m_uniformNames.push_back("currentFrame");
 	m_uniformNames.push_back("frameCount");
+	m_uniformNames.push_back("u_uvRect");
+	m_uniformNames.push_back("u_color");
 
 	std::string vertexSource = ReadShaderFile(vertexPath);
 	std::string fragmentSource = ReadShaderFile(fragmentPath);
@@ -77,6 +79,12 @@ void Shader::Compile(const std::string& vertexSource, const std::string& fragmen
 			m_uniformLocations[it.c_str()] = glGetUniformLocation(m_iProgramId, it.c_str());
 		}
 
+		// untinted until an object sets a color
+		if (m_uniformLocations["u_color"] != -1)
+		{
+			glUniform4f(m_uniformLocations["u_color"], 1.f, 1.f, 1.f, 1.f);
+		}
+
 		glUseProgram(0);
 		// Delete the vertex and fragment shaders after linking (if successful)
 		glDeleteShader(vertexShader);
@@ -2,22 +2,76 @@
 
 #include <iostream>
 #include <soloud/soloud_wav.h>
+#include <soloud/soloud_wavstream.h>
+#include <soloud/soloud_file.h>
 
+#include "SoundBank.h"
 
-Sound::Sound(const std::string& filename)
+
+Sound::Sound() :
+	m_sound(std::make_shared<SoLoud::Wav>()), m_streaming(false), m_ready(false), m_priority(0), m_maxInstances(0), m_cooldown(0.f), m_lastPlayTime(-1e9), m_bus(SoundBus::SFX)
+{
+}
+
+Sound::Sound(const std::string& filename, bool streaming) :
+	m_streaming(streaming), m_ready(true), m_priority(0), m_maxInstances(0), m_cooldown(0.f), m_lastPlayTime(-1e9),
+	m_bus(streaming ? SoundBus::MUSIC : SoundBus::SFX)
 {
-	m_sound = std::make_shared<SoLoud::Wav>();
+	if (m_streaming)
+	{
+		m_sound = std::make_shared<SoLoud::WavStream>();
+	}
+	else
+	{
+		m_sound = std::make_shared<SoLoud::Wav>();
+	}
 	LoadSound(filename.c_str());
 }
 
+Sound::Sound(const std::shared_ptr<SoundBank>& bank, size_t index) :
+	m_streaming(false), m_ready(true), m_bank(bank), m_priority(0), m_maxInstances(0), m_cooldown(0.f), m_lastPlayTime(-1e9), m_bus(SoundBus::SFX)
+{
+	auto wav = std::make_shared<SoLoud::Wav>();
+	m_sound = wav;
+
+	const float* samples;
+	unsigned int sampleCount;
+	float sampleRate;
+	unsigned int channels;
+	if (!m_bank || !m_bank->GetSound(index, samples, sampleCount, sampleRate, channels))
+	{
+		std::cout << "Failed to load sound " << index << " from sound bank\n";
+		m_bank = nullptr;
+		return;
+	}
+
+	// the Wav points into the bank mapping, the samples are read only
+	wav->loadRawWave(const_cast<float*>(samples), sampleCount * channels, sampleRate, channels, false, true);
+}
+
 Sound::~Sound()
 {
+	if (m_bank)
+	{
+		// the Wav frees its samples on destruction, they belong to the bank here
+		SoLoud::Wav* wav = static_cast<SoLoud::Wav*>(m_sound.get());
+		wav->stop();
+		wav->mData = nullptr;
+	}
 	m_sound = nullptr;
+	m_bank = nullptr;
 }
 
 void Sound::LoadSound(const std::string& filename)
 {
-	SoLoud::result r = m_sound->load(filename.c_str());
+	if (m_bank)
+	{
+		return;
+	}
+
+	// a stream only reads the header here, the samples are decoded while playing
+	SoLoud::result r = m_streaming ? static_cast<SoLoud::WavStream*>(m_sound.get())->load(filename.c_str())
+		: static_cast<SoLoud::Wav*>(m_sound.get())->load(filename.c_str());
 	if (r != SoLoud::SO_NO_ERROR)
 	{
 		std::cout << "Failed to load sound: " << filename << "\n";
@@ -41,5 +95,67 @@ void Sound::Stop()
 
 float Sound::GetLength()
 {
-	return static_cast<float>(m_sound->getLength());
+	if (m_streaming)
+	{
+		return static_cast<float>(static_cast<SoLoud::WavStream*>(m_sound.get())->getLength());
+	}
+	return static_cast<float>(static_cast<SoLoud::Wav*>(m_sound.get())->getLength());
+}
+
+bool Sound::IsStreaming() const
+{
+	return m_streaming;
+}
+
+size_t Sound::GetMemorySize() const
+{
+	if (m_streaming)
+	{
+		// streams loaded from memory keep the encoded file
+		SoLoud::WavStream* stream = static_cast<SoLoud::WavStream*>(m_sound.get());
+		return stream->mMemFile ? stream->mMemFile->length() : 0;
+	}
+
+	SoLoud::Wav* wav = static_cast<SoLoud::Wav*>(m_sound.get());
+	return static_cast<size_t>(wav->mSampleCount) * wav->mChannels * sizeof(float);
+}
+
+bool Sound::IsReady() const
+{
+	return m_ready;
+}
+
+void Sound::FinishLoad(const std::shared_ptr<SoLoud::Wav>& wav)
+{
+	// settings made on the placeholder carry over to the loaded sound
+	wav->setVolume(m_sound->mVolume);
+	wav->setLooping((m_sound->mFlags & SoLoud::AudioSource::SHOULD_LOOP) != 0);
+	m_sound = wav;
+	m_ready = true;
+}
+
+void Sound::SetPriority(int priority)
+{
+	m_priority = priority;
+}
+
+void Sound::SetMaxInstances(int maxInstances)
+{
+	m_maxInstances = maxInstances > 0 ? maxInstances : 0;
+}
+
+void Sound::SetCooldown(float cooldown)
+{
+	m_cooldown = cooldown > 0.f ? cooldown : 0.f;
 }
+
+
+void Sound::SetBus(SoundBus bus)
+{
+	m_bus = bus;
+}
+
+SoundBus Sound::GetBus() const
+{
+	return m_bus;
+}
\ No newline at end of file
@@ -1,33 +1,54 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <memory>
 
 namespace SoLoud
 {
+	class AudioSource;
 	class Wav;
 }
 
+class SoundBank;
+
+/**
+ * @brief The mix buses a sound plays through, see SoundPlayer.
+ */
+enum class SoundBus
+{
+	MUSIC,
+	SFX,
+	UI,
+	VOICE,
+	COUNT
+};
+
 /**
  * @class Sound
  * @brief Manages an audio sound.
  *
  * This class handles loading, playing, and managing properties of an audio sound.
+ * A sound is either decoded whole into memory when loaded, which suits short effects, or
+ * streamed: decoded bit by bit from the file while it plays, which suits music. A sound can also
+ * play samples already decoded into a SoundBank, which keeps the bank alive.
  */
 class Sound
 {
 public:
-	/**
-	 * @brief Deleted default constructor to prevent creating an uninitialized Sound object.
-	 */
-	Sound() = delete;
-
 	/**
 	 * @brief Constructs a Sound object and loads a sound from a file.
 	 * @param filename The path to the sound file.
+	 * @param streaming True to decode the file while playing instead of decoding it whole now.
 	 */
-	Sound(const std::string& filename);
+	Sound(const std::string& filename, bool streaming = false);
 
+	/**
+	 * @brief Constructs a Sound object playing a sound of a bank, without copying its samples.
+	 * @param bank The bank holding the samples.
+	 * @param index The index of the sound in the bank.
+	 */
+	Sound(const std::shared_ptr<SoundBank>& bank, size_t index);
 
 	/**
 	 * @brief Destroys the Sound object and releases associated resources.
@@ -35,7 +56,7 @@ public:
 	~Sound();
 
 	/**
-	 * @brief Loads a sound from a file.
+	 * @brief Loads a sound from a file. Does nothing for a sound of a bank.
 	 * @param filename The path to the sound file.
 	 */
 	void LoadSound(const std::string& filename);
@@ -64,7 +85,79 @@ public:
 	 */
 	float GetLength();
 
-	friend class SoundPlayer;	///< Grants the SoundPlayer class access to Sound's private members.
+	/**
+	 * @brief Checks if the sound is streamed from its file.
+	 * @return True for a streamed sound.
+	 */
+	bool IsStreaming() const;
+
+	/**
+	 * @brief Checks if the sound is loaded.
+	 * @return False while a sound loaded by ResourceManager::LoadSoundAsync is decoding.
+	 */
+	bool IsReady() const;
+
+	/**
+	 * @brief Gets the memory held by the sound.
+	 * @return The size of the decoded samples in bytes, 0 for a streamed sound.
+	 *
+	 * A streamed sound holds no samples, each playing instance only has a small decode buffer.
+	 */
+	size_t GetMemorySize() const;
+
+	/**
+	 * @brief Sets the priority of the sound when voices run out.
+	 * @param priority The priority, 0 by default. A sound can only take the voice of a sound of lower or equal priority.
+	 */
+	void SetPriority(int priority);
+
+	/**
+	 * @brief Sets the number of instances of the sound that can play at once.
+	 * @param maxInstances The instance count, 0 for no limit (the default).
+	 *
+	 * Playing one more instance stops the oldest one.
+	 */
+	void SetMaxInstances(int maxInstances);
+
+	/**
+	 * @brief Sets the minimum time between two plays of the sound.
+	 * @param cooldown The time in seconds, 0 by default. Plays inside it are ignored.
+	 */
+	void SetCooldown(float cooldown);
+
+	/**
+	 * @brief Sets the bus the sound plays through. Takes effect for the next plays.
+	 * @param bus The bus, MUSIC by default for streamed sounds and SFX for the others.
+	 */
+	void SetBus(SoundBus bus);
+
+	/**
+	 * @brief Gets the bus the sound plays through.
+	 * @return The bus.
+	 */
+	SoundBus GetBus() const;
+
+	friend class SoundPlayer;		///< Grants the SoundPlayer class access to Sound's private members.
+	friend class ResourceManager;	///< Grants the ResourceManager access to the background loading.
 private:
-	std::shared_ptr<SoLoud::Wav> m_sound;	///< The sound object from the SoLoud library.
+	/**
+	 * @brief Constructs a sound that is not ready, ResourceManager::LoadSoundAsync loads it.
+	 */
+	Sound();
+
+	/**
+	 * @brief Takes the samples decoded in the background and marks the sound as ready.
+	 * @param wav The decoded sound. The volume and looping set meanwhile are kept.
+	 */
+	void FinishLoad(const std::shared_ptr<SoLoud::Wav>& wav);
+
+	std::shared_ptr<SoLoud::AudioSource> m_sound;	///< The sound object from the SoLoud library, a Wav or a WavStream.
+	bool m_streaming;								///< True when m_sound is a WavStream.
+	bool m_ready;									///< False while the samples are decoded in the background.
+	std::shared_ptr<SoundBank> m_bank;				///< The bank holding the samples of m_sound, if any.
+	int m_priority;									///< Priority when voices run out.
+	int m_maxInstances;								///< Instances playing at once, 0 for no limit.
+	float m_cooldown;								///< Minimum time between two plays, in seconds.
+	double m_lastPlayTime;							///< Time of the last play, in seconds.
+	SoundBus m_bus;									///< The bus the sound plays through.
 };
\ No newline at end of file
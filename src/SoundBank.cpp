@@ -0,0 +1,272 @@
+#include "SoundBank.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <soloud/soloud_wav.h>
+
+#include "Config.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+namespace fs = std::filesystem;
+
+static const char BANK_MAGIC[4] = { 'G', 'S', 'B', 'K' };
+static const uint32_t BANK_VERSION = 1;
+static const size_t MAX_SOURCE_PATH = 95;
+
+/**
+ * @brief Start of a .gsbank file, followed by the sound table and the samples.
+ */
+struct BankHeader
+{
+	char magic[4];			///< "GSBK".
+	uint32_t version;		///< Format version.
+	uint32_t soundCount;	///< Number of sounds.
+	uint32_t downmix;		///< 1 if the sounds were mixed down to mono.
+	uint32_t sampleRate;	///< Sample rate the sounds were resampled to, 0 if kept.
+	uint32_t reserved;		///< Zero.
+};
+
+/**
+ * @brief A sound in the sound table.
+ */
+struct BankSound
+{
+	char sourcePath[MAX_SOURCE_PATH + 1];	///< The source file, zero terminated.
+	uint64_t sourceSize;					///< Size of the source when the bank was written.
+	int64_t sourceTime;						///< Modification time of the source when the bank was written.
+	uint64_t offset;						///< Position of the samples from the start of the file.
+	uint32_t sampleCount;					///< Number of samples per channel.
+	uint32_t channels;						///< Channel count.
+	float sampleRate;						///< Samples per second.
+	uint32_t reserved;						///< Zero.
+};
+
+static_assert(sizeof(BankHeader) == 24, "BankHeader is written as is");
+static_assert(sizeof(BankSound) == 136, "BankSound is written as is");
+
+static bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time)
+{
+	std::error_code error;
+	size = static_cast<uint64_t>(fs::file_size(sourcePath, error));
+	if (error)
+	{
+		return false;
+	}
+	time = static_cast<int64_t>(fs::last_write_time(sourcePath, error).time_since_epoch().count());
+	return !error;
+}
+
+/**
+ * @brief Converts the samples of a decoded sound, each channel after the other.
+ */
+static std::vector<float> ConvertSamples(const float* data, unsigned int sampleCount, unsigned int& channels, float& sampleRate, const SoundBankOptions& options)
+{
+	std::vector<float> samples(data, data + static_cast<size_t>(sampleCount) * channels);
+
+	if (options.downmix && channels > 1)
+	{
+		std::vector<float> mono(sampleCount, 0.f);
+		for (unsigned int channel = 0; channel < channels; channel++)
+		{
+			const float* source = samples.data() + static_cast<size_t>(channel) * sampleCount;
+			for (unsigned int i = 0; i < sampleCount; i++)
+			{
+				mono[i] += source[i] / channels;
+			}
+		}
+		samples.swap(mono);
+		channels = 1;
+	}
+
+	if (options.sampleRate > 0 && sampleRate > 0.f && static_cast<unsigned int>(sampleRate) != options.sampleRate && sampleCount > 1)
+	{
+		// linear interpolation is enough for short effects
+		unsigned int resampledCount = std::max(static_cast<unsigned int>(static_cast<double>(sampleCount) * options.sampleRate / sampleRate), 1u);
+		std::vector<float> resampled(static_cast<size_t>(resampledCount) * channels);
+		double step = sampleRate / options.sampleRate;
+		for (unsigned int channel = 0; channel < channels; channel++)
+		{
+			const float* source = samples.data() + static_cast<size_t>(channel) * sampleCount;
+			float* destination = resampled.data() + static_cast<size_t>(channel) * resampledCount;
+			for (unsigned int i = 0; i < resampledCount; i++)
+			{
+				double position = i * step;
+				unsigned int index = std::min(static_cast<unsigned int>(position), sampleCount - 2);
+				float t = static_cast<float>(std::min(position - index, 1.0));
+				destination[i] = source[index] + (source[index + 1] - source[index]) * t;
+			}
+		}
+		samples.swap(resampled);
+		sampleRate = static_cast<float>(options.sampleRate);
+	}
+	return samples;
+}
+
+std::shared_ptr<SoundBank> SoundBank::Open(const std::string& path, const std::vector<std::string>& sourcePaths, const SoundBankOptions& options)
+{
+	PROFILE_SCOPE("SoundBank::Open");
+
+	std::shared_ptr<SoundBank> bank(new SoundBank());
+	MappedFile& file = bank->m_file;
+	if (!file.Open(path) || file.GetSize() < sizeof(BankHeader))
+	{
+		return nullptr;
+	}
+
+	// banks written for other sounds or options are skipped, Write replaces them
+	BankHeader header;
+	std::memcpy(&header, file.GetData(), sizeof(header));
+	if (std::memcmp(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC)) != 0 || header.version != BANK_VERSION
+		|| header.soundCount != sourcePaths.size() || header.downmix != (options.downmix ? 1u : 0u)
+		|| header.sampleRate != options.sampleRate
+		|| file.GetSize() < sizeof(BankHeader) + header.soundCount * sizeof(BankSound))
+	{
+		return nullptr;
+	}
+
+	std::vector<BankSound> sounds(header.soundCount);
+	std::memcpy(sounds.data(), file.GetData() + sizeof(BankHeader), sounds.size() * sizeof(BankSound));
+	for (size_t i = 0; i < sounds.size(); i++)
+	{
+		const BankSound& sound = sounds[i];
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (std::strncmp(sound.sourcePath, sourcePaths[i].c_str(), sizeof(sound.sourcePath)) != 0
+			|| !GetSourceStamp(sourcePaths[i], sourceSize, sourceTime)
+			|| sound.sourceSize != sourceSize || sound.sourceTime != sourceTime)
+		{
+			return nullptr;
+		}
+
+		uint64_t size = static_cast<uint64_t>(sound.sampleCount) * sound.channels * sizeof(float);
+		if (sound.sampleCount == 0 || sound.channels == 0 || sound.offset % sizeof(float) != 0
+			|| sound.offset > file.GetSize() || size > file.GetSize() - sound.offset)
+		{
+			LogWarning("Corrupted sound bank %s", path.c_str());
+			return nullptr;
+		}
+
+		Entry entry;
+		entry.samples = reinterpret_cast<const float*>(file.GetData() + sound.offset);
+		entry.sampleCount = sound.sampleCount;
+		entry.sampleRate = sound.sampleRate;
+		entry.channels = sound.channels;
+		bank->m_entries.push_back(entry);
+	}
+	return bank;
+}
+
+bool SoundBank::Write(const std::string& path, const std::vector<std::string>& sourcePaths, const SoundBankOptions& options)
+{
+	PROFILE_SCOPE("SoundBank::Write");
+
+	BankHeader header;
+	std::memcpy(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC));
+	header.version = BANK_VERSION;
+	header.soundCount = static_cast<uint32_t>(sourcePaths.size());
+	header.downmix = options.downmix ? 1 : 0;
+	header.sampleRate = options.sampleRate;
+	header.reserved = 0;
+
+	std::vector<BankSound> sounds(sourcePaths.size());
+	std::vector<std::vector<float>> samples(sourcePaths.size());
+	uint64_t offset = sizeof(BankHeader) + sounds.size() * sizeof(BankSound);
+	for (size_t i = 0; i < sourcePaths.size(); i++)
+	{
+		BankSound& sound = sounds[i];
+		std::memset(&sound, 0, sizeof(sound));
+		if (sourcePaths[i].size() > MAX_SOURCE_PATH || !GetSourceStamp(sourcePaths[i], sound.sourceSize, sound.sourceTime))
+		{
+			LogWarning("Can not add %s to sound bank %s", sourcePaths[i].c_str(), path.c_str());
+			return false;
+		}
+		std::memcpy(sound.sourcePath, sourcePaths[i].c_str(), sourcePaths[i].size());
+
+		SoLoud::Wav wav;
+		if (wav.load(sourcePaths[i].c_str()) != SoLoud::SO_NO_ERROR || wav.mSampleCount == 0)
+		{
+			LogWarning("Can not decode %s for sound bank %s", sourcePaths[i].c_str(), path.c_str());
+			return false;
+		}
+
+		unsigned int channels = wav.mChannels;
+		float sampleRate = wav.mBaseSamplerate;
+		samples[i] = ConvertSamples(wav.mData, wav.mSampleCount, channels, sampleRate, options);
+		sound.sampleCount = static_cast<uint32_t>(samples[i].size() / channels);
+		sound.channels = channels;
+		sound.sampleRate = sampleRate;
+
+		offset = (offset + 15) & ~uint64_t(15);
+		sound.offset = offset;
+		offset += samples[i].size() * sizeof(float);
+	}
+
+	std::error_code error;
+	fs::create_directories(fs::path(path).parent_path(), error);
+
+	// written aside then renamed, readers never see a partial file
+	std::string temporaryPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	{
+		std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!output.is_open())
+		{
+			LogWarning("Can not write sound bank %s", path.c_str());
+			return false;
+		}
+
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(sounds.data()), static_cast<std::streamsize>(sounds.size() * sizeof(BankSound)));
+		for (size_t i = 0; i < sounds.size(); i++)
+		{
+			static const char zeros[16] = {};
+			std::streamoff padding = static_cast<std::streamoff>(sounds[i].offset) - output.tellp();
+			output.write(zeros, padding);
+			output.write(reinterpret_cast<const char*>(samples[i].data()), static_cast<std::streamsize>(samples[i].size() * sizeof(float)));
+		}
+		if (!output.good())
+		{
+			output.close();
+			fs::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	fs::rename(temporaryPath, path, error);
+	if (error)
+	{
+		fs::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+std::string SoundBank::GetBankPath(const std::string& bankName)
+{
+	return CachePath::SOUND + bankName + ".gsbank";
+}
+
+size_t SoundBank::GetSoundCount() const
+{
+	return m_entries.size();
+}
+
+bool SoundBank::GetSound(size_t index, const float*& samples, unsigned int& sampleCount, float& sampleRate, unsigned int& channels) const
+{
+	if (index >= m_entries.size())
+	{
+		return false;
+	}
+
+	const Entry& entry = m_entries[index];
+	samples = entry.samples;
+	sampleCount = entry.sampleCount;
+	sampleRate = entry.sampleRate;
+	channels = entry.channels;
+	return true;
+}
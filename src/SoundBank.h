@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/**
+ * @brief How the sounds are converted when a bank is written.
+ */
+struct SoundBankOptions
+{
+	bool downmix = false;			///< True to mix the channels of each sound down to mono.
+	unsigned int sampleRate = 0;	///< Sample rate the sounds are resampled to, 0 to keep the rate of each sound.
+};
+
+/**
+ * @class SoundBank
+ * @brief Many short sounds decoded once and stored as PCM in one .gsbank file.
+ *
+ * The bank holds the float samples of each sound the way SoLoud keeps them in memory, one
+ * channel after the other. It is mapped and the sounds play straight from the mapping, so
+ * loading a bank costs no decoding and no copy. Each sound records the size and modification
+ * time of its source file, a bank is ignored once a source changes.
+ */
+class SoundBank
+{
+public:
+	/**
+	 * @brief Maps a bank.
+	 * @param path The path to the .gsbank file.
+	 * @param sourcePaths The source files the bank must hold, in order.
+	 * @param options The conversion the bank must have been written with.
+	 * @return The bank, nullptr if it is missing, stale, or holds other sounds.
+	 */
+	static std::shared_ptr<SoundBank> Open(const std::string& path, const std::vector<std::string>& sourcePaths, const SoundBankOptions& options);
+
+	/**
+	 * @brief Decodes sound files and writes them into a bank.
+	 * @param path The path to the .gsbank file.
+	 * @param sourcePaths The source files. Supported file extensions: WAV, MP3, FLAC, OGG
+	 * @param options The conversion of the sounds.
+	 * @return True if the bank was written.
+	 */
+	static bool Write(const std::string& path, const std::vector<std::string>& sourcePaths, const SoundBankOptions& options);
+
+	/**
+	 * @brief Gets the file of a bank in the cache folder.
+	 * @param bankName The name of the bank.
+	 * @return The path to the .gsbank file.
+	 */
+	static std::string GetBankPath(const std::string& bankName);
+
+	/**
+	 * @brief Gets the number of sounds in the bank.
+	 * @return The sound count.
+	 */
+	size_t GetSoundCount() const;
+
+	/**
+	 * @brief Gets the samples of a sound.
+	 * @param index The index of the sound, in the order of the source files.
+	 * @param samples Receives the samples, each channel after the other. Valid while the bank lives.
+	 * @param sampleCount Receives the number of samples per channel.
+	 * @param sampleRate Receives the sample rate.
+	 * @param channels Receives the channel count.
+	 * @return False if the index is out of range.
+	 */
+	bool GetSound(size_t index, const float*& samples, unsigned int& sampleCount, float& sampleRate, unsigned int& channels) const;
+
+private:
+	/**
+	 * @brief A sound in the mapping.
+	 */
+	struct Entry
+	{
+		const float* samples;		///< The samples, each channel after the other.
+		unsigned int sampleCount;	///< Number of samples per channel.
+		float sampleRate;			///< Samples per second.
+		unsigned int channels;		///< Channel count.
+	};
+
+	MappedFile m_file;				///< The mapped bank.
+	std::vector<Entry> m_entries;	///< The sounds.
+};
\ No newline at end of file
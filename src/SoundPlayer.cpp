@@ -1,34 +1,94 @@
 #include "SoundPlayer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
 #include <iostream>
+#include <limits>
 
 #include <soloud/soloud.h>
 #include <soloud/soloud_wav.h>
+#include <soloud/soloud_bus.h>
+#include <soloud/soloud_duckfilter.h>
 
 #include "Sound.h"
+#include "Camera.h"
+#include "Profiler.h"
 
-void SoundPlayer::Init()
+// SoLoud can not mix more voices than this
+static const int MAX_ACTIVE_VOICES = 255;
+
+// each bus is a voice of its own
+static const int BUS_COUNT = static_cast<int>(SoundBus::COUNT);
+
+// seconds before a one shot still playing past its expected end is checked again
+static const double RECLAIM_RECHECK_DELAY = 0.1;
+
+static double GetTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SoundPlayer::Init(const SoundPlayerConfig& config)
 {
     m_SoloudPlayer = std::make_shared<SoLoud::Soloud>();
-#if defined(WITH_SDL2_STATIC)
-    int result = m_SoloudPlayer->init(SoLoud::Soloud::CLIP_ROUNDOFF, SoLoud::Soloud::SDL2);
-    if (result != SoLoud::SO_NO_ERROR)
+    unsigned int sampleRate = config.sampleRate ? config.sampleRate : static_cast<unsigned int>(SoLoud::Soloud::AUTO);
+    unsigned int bufferSize = config.bufferSize ? config.bufferSize : static_cast<unsigned int>(SoLoud::Soloud::AUTO);
+    if (config.nullDriver)
     {
-        std::cerr << "Failed to initialize SoLoud with SDL2 backend." << std::endl;
+        int result = m_SoloudPlayer->init(SoLoud::Soloud::CLIP_ROUNDOFF, SoLoud::Soloud::NULLDRIVER, sampleRate, bufferSize, config.channels);
+        if (result != SoLoud::SO_NO_ERROR)
+        {
+            std::cerr << "Failed to initialize SoLoud with the null driver." << std::endl;
+        }
     }
+    else
+    {
+#if defined(WITH_SDL2_STATIC)
+        int result = m_SoloudPlayer->init(SoLoud::Soloud::CLIP_ROUNDOFF, SoLoud::Soloud::SDL2, sampleRate, bufferSize, config.channels);
+        if (result != SoLoud::SO_NO_ERROR)
+        {
+            std::cerr << "Failed to initialize SoLoud with SDL2 backend." << std::endl;
+        }
 #else
-    int result = m_SoloudPlayer->init();
-    if (result != SoLoud::SO_NO_ERROR)
+        int result = m_SoloudPlayer->init(SoLoud::Soloud::CLIP_ROUNDOFF, SoLoud::Soloud::AUTO, sampleRate, bufferSize, config.channels);
+        if (result != SoLoud::SO_NO_ERROR)
+        {
+            std::cerr << "Failed to initialize SoLoud." << std::endl;
+        }
+#endif
+    }
+    SetMaxVoices(config.maxVoices);
+
+    // the buses play for the lifetime of the player, the sounds are played through them
+    for (auto& mixBus : m_buses)
     {
-        std::cerr << "Failed to initialize SoLoud." << std::endl;
+        mixBus = MixBus();
+        mixBus.bus = std::make_shared<SoLoud::Bus>();
+        mixBus.bus->setChannels(config.channels);
+        mixBus.handle = m_SoloudPlayer->play(*mixBus.bus);
+        m_SoloudPlayer->setProtectVoice(mixBus.handle, true);
+        // a silent bus keeps its sounds going
+        m_SoloudPlayer->setInaudibleBehavior(mixBus.handle, true, false);
+        mixBus.group = m_SoloudPlayer->createVoiceGroup();
     }
-#endif
 }
 
 void SoundPlayer::Deinit()
 {
+    // a bus stops its sounds when destroyed, the engine must still be there
+    for (auto& mixBus : m_buses)
+    {
+        m_SoloudPlayer->destroyVoiceGroup(mixBus.group);
+        mixBus = MixBus();
+    }
     m_SoloudPlayer->deinit();
     m_SoloudPlayer = nullptr;
+    m_listener = nullptr;
+    m_voices.clear();
+    m_pendingPlays.clear();
+    m_pendingSounds.clear();
+    m_pendingCommands.clear();
 }
 
 unsigned int SoundPlayer::Play(std::shared_ptr<Sound> sound)
@@ -37,43 +97,573 @@ unsigned int SoundPlayer::Play(std::shared_ptr<Sound> sound)
     {
         return 0;
     }
-    unsigned int handle = m_SoloudPlayer->play(*(sound->m_sound.get()));
-    m_handles.push_back(handle);
-    return handle;
+
+    // the same sound triggered again this frame plays once
+    auto pending = m_pendingSounds.find(sound.get());
+    if (pending != m_pendingSounds.end())
+    {
+        return m_pendingPlays[pending->second].id;
+    }
+
+    // repeated triggers inside the cooldown are dropped
+    double now = GetTime();
+    if (now - sound->m_lastPlayTime < sound->m_cooldown)
+    {
+        return 0;
+    }
+    sound->m_lastPlayTime = now;
+
+    unsigned int id = m_nextId++;
+    if (m_nextId == 0)
+    {
+        m_nextId = 1;
+    }
+    m_pendingSounds[sound.get()] = m_pendingPlays.size();
+    m_pendingPlays.push_back({ id, sound, -1.f, false, false, now });
+    return id;
+}
+
+unsigned int SoundPlayer::PlayAt(std::shared_ptr<Sound> sound, const glm::vec2& position)
+{
+    unsigned int id = Play(sound);
+    PendingPlay* play = FindPendingPlay(id);
+    if (play)
+    {
+        play->positional = true;
+        play->position = position;
+    }
+    return id;
+}
+
+void SoundPlayer::SetPosition(unsigned int handle, const glm::vec2& position)
+{
+    PendingPlay* play = FindPendingPlay(handle);
+    if (play)
+    {
+        play->position = position;
+        return;
+    }
+
+    // sent with the other positions at the next Update
+    for (auto& voice : m_voices)
+    {
+        if (voice.id == handle && voice.positional)
+        {
+            voice.position = position;
+            voice.moved = true;
+            return;
+        }
+    }
+}
+
+void SoundPlayer::SetListener(const std::shared_ptr<Camera>& camera)
+{
+    m_listener = camera;
+}
+
+void SoundPlayer::SetAttenuation(float minDistance, float maxDistance)
+{
+    m_minDistance = std::max(minDistance, 0.f);
+    m_maxDistance = std::max(maxDistance, m_minDistance + 1.f);
+}
+
+void SoundPlayer::Update()
+{
+    PROFILE_SCOPE("SoundPlayer::Update");
+
+    m_volumesRead = false;
+    ReclaimVoices();
+    // the listener is set first so the new voices start with the right volume and panning
+    Update3dAudio();
+    FlushCommands();
+}
+
+void SoundPlayer::SetMaxVoices(int maxVoices)
+{
+    m_maxVoices = std::min(std::max(maxVoices, 1), MAX_ACTIVE_VOICES - BUS_COUNT);
+    if (m_SoloudPlayer)
+    {
+        // every voice kept is audible, none is made virtual by SoLoud
+        m_SoloudPlayer->setMaxActiveVoiceCount(m_maxVoices + BUS_COUNT);
+    }
+
+    while (static_cast<int>(m_voices.size()) > m_maxVoices && StealVoice(nullptr, INT_MAX))
+    {
+    }
+}
+
+void SoundPlayer::SetLoadWait(float seconds)
+{
+    m_loadWait = seconds;
+}
+
+void SoundPlayer::Mix(float* buffer, unsigned int sampleCount)
+{
+    PROFILE_SCOPE("SoundPlayer::Mix");
+
+    m_SoloudPlayer->mix(buffer, sampleCount);
+}
+
+unsigned int SoundPlayer::GetSampleRate() const
+{
+    return m_SoloudPlayer->getBackendSamplerate();
+}
+
+unsigned int SoundPlayer::GetBufferSize() const
+{
+    return m_SoloudPlayer->getBackendBufferSize();
+}
+
+unsigned int SoundPlayer::GetChannelCount() const
+{
+    return m_SoloudPlayer->getBackendChannels();
+}
+
+size_t SoundPlayer::GetVoiceCount() const
+{
+    return m_voices.size();
 }
 
 void SoundPlayer::SetVolume(int handle, float volume)
 {
-    m_SoloudPlayer->setVolume(handle, volume);
+    PendingPlay* play = FindPendingPlay(handle);
+    if (play)
+    {
+        play->volume = volume;
+        return;
+    }
+
+    PendingCommand& command = m_pendingCommands[handle];
+    command.volume = volume;
+    command.hasVolume = true;
 }
 
 void SoundPlayer::Pause(unsigned int handle)
 {
-    m_SoloudPlayer->setPause(handle, true);
+    PendingPlay* play = FindPendingPlay(handle);
+    if (play)
+    {
+        play->paused = true;
+        return;
+    }
+    m_pendingCommands[handle].pause = 1;
 }
 
 void SoundPlayer::Resume(unsigned int handle)
 {
-    m_SoloudPlayer->setPause(handle, false);
+    PendingPlay* play = FindPendingPlay(handle);
+    if (play)
+    {
+        play->paused = false;
+        return;
+    }
+    m_pendingCommands[handle].pause = 0;
 }
 
 void SoundPlayer::Stop(unsigned int handle)
 {
-    m_SoloudPlayer->stop(handle);
+    PendingPlay* play = FindPendingPlay(handle);
+    if (play)
+    {
+        play->cancelled = true;
+        m_pendingSounds.erase(play->sound.get());
+        return;
+    }
+    m_pendingCommands[handle].stop = true;
 }
 
 void SoundPlayer::PauseAll()
 {
-    m_SoloudPlayer->setPauseAll(true);
+    // one call per bus, whatever the number of sounds
+    for (int i = 0; i < BUS_COUNT; i++)
+    {
+        PauseBus(static_cast<SoundBus>(i));
+    }
 }
 
 void SoundPlayer::StopAll()
 {
-    m_SoloudPlayer->stopAll();
+    for (const auto& mixBus : m_buses)
+    {
+        m_SoloudPlayer->stop(mixBus.group);
+    }
+    m_voices.clear();
+    m_pendingPlays.clear();
+    m_pendingSounds.clear();
+    m_pendingCommands.clear();
 }
 
 void SoundPlayer::ResumeAll()
 {
-    m_SoloudPlayer->setPauseAll(false);
+    for (int i = 0; i < BUS_COUNT; i++)
+    {
+        ResumeBus(static_cast<SoundBus>(i));
+    }
+}
+
+void SoundPlayer::SetBusVolume(SoundBus bus, float volume, float fadeTime)
+{
+    MixBus& mixBus = GetMixBus(bus);
+    mixBus.volume = volume;
+    if (fadeTime > 0.f)
+    {
+        m_SoloudPlayer->fadeVolume(mixBus.handle, volume, fadeTime);
+    }
+    else
+    {
+        m_SoloudPlayer->setVolume(mixBus.handle, volume);
+    }
+}
+
+float SoundPlayer::GetBusVolume(SoundBus bus) const
+{
+    return m_buses[static_cast<int>(bus)].volume;
+}
+
+void SoundPlayer::PauseBus(SoundBus bus)
+{
+    // the sounds of a paused bus are not mixed, the ones started meanwhile wait with it
+    m_SoloudPlayer->setPause(GetMixBus(bus).handle, true);
+}
+
+void SoundPlayer::ResumeBus(SoundBus bus)
+{
+    m_SoloudPlayer->setPause(GetMixBus(bus).handle, false);
 }
 
+void SoundPlayer::StopBus(SoundBus bus)
+{
+    m_SoloudPlayer->stop(GetMixBus(bus).group);
+
+    m_voices.erase(std::remove_if(m_voices.begin(), m_voices.end(),
+        [&](const Voice& voice) { return voice.bus == bus; }), m_voices.end());
+    for (auto& play : m_pendingPlays)
+    {
+        if (play.sound->m_bus == bus && !play.cancelled)
+        {
+            play.cancelled = true;
+            m_pendingSounds.erase(play.sound.get());
+        }
+    }
+}
+
+void SoundPlayer::SetDucking(SoundBus trigger, SoundBus target, float level, float attack, float release)
+{
+    if (trigger == target)
+    {
+        return;
+    }
+
+    ClearDucking(target);
+
+    // the filter reads the output level of the trigger bus, which is only measured on request
+    MixBus& triggerBus = GetMixBus(trigger);
+    if (triggerBus.duckListeners++ == 0)
+    {
+        triggerBus.bus->setVisualizationEnable(true);
+    }
+
+    MixBus& targetBus = GetMixBus(target);
+    targetBus.ducking = std::make_shared<SoLoud::DuckFilter>();
+    targetBus.ducking->setParams(m_SoloudPlayer.get(), triggerBus.handle, attack, release, level);
+    targetBus.duckTrigger = trigger;
+    targetBus.bus->setFilter(0, targetBus.ducking.get());
+}
+
+void SoundPlayer::ClearDucking(SoundBus target)
+{
+    MixBus& targetBus = GetMixBus(target);
+    if (!targetBus.ducking)
+    {
+        return;
+    }
+
+    targetBus.bus->setFilter(0, nullptr);
+    targetBus.ducking = nullptr;
+
+    MixBus& triggerBus = GetMixBus(targetBus.duckTrigger);
+    if (--triggerBus.duckListeners == 0)
+    {
+        triggerBus.bus->setVisualizationEnable(false);
+    }
+    targetBus.duckTrigger = SoundBus::COUNT;
+}
+
+void SoundPlayer::FlushCommands()
+{
+    // commands on playing voices first, new voices carry their volume and pause state
+    for (const auto& it : m_pendingCommands)
+    {
+        auto voice = std::find_if(m_voices.begin(), m_voices.end(),
+            [&](const Voice& voice) { return voice.id == it.first; });
+        if (voice == m_voices.end())
+        {
+            continue;
+        }
+
+        const PendingCommand& command = it.second;
+        if (command.stop)
+        {
+            m_SoloudPlayer->stop(voice->handle);
+            m_voices.erase(voice);
+            continue;
+        }
+        if (command.hasVolume)
+        {
+            m_SoloudPlayer->setVolume(voice->handle, command.volume);
+        }
+        if (command.pause >= 0)
+        {
+            // a culled voice stays paused until it is back in range
+            voice->paused = command.pause != 0;
+            if (!voice->culled)
+            {
+                m_SoloudPlayer->setPause(voice->handle, voice->paused);
+            }
+        }
+    }
+    m_pendingCommands.clear();
+
+    // sounds still loading wait for a later frame, until the load wait runs out
+    std::vector<PendingPlay> waitingPlays;
+    double now = GetTime();
+    for (const auto& play : m_pendingPlays)
+    {
+        if (play.cancelled)
+        {
+            continue;
+        }
+        if (!play.sound->IsReady())
+        {
+            if (m_loadWait < 0.f || now - play.startTime < m_loadWait)
+            {
+                waitingPlays.push_back(play);
+            }
+            continue;
+        }
+        StartVoice(play);
+    }
+
+    m_pendingPlays.swap(waitingPlays);
+    m_pendingSounds.clear();
+    for (size_t i = 0; i < m_pendingPlays.size(); i++)
+    {
+        m_pendingSounds[m_pendingPlays[i].sound.get()] = i;
+    }
+}
+
+void SoundPlayer::StartVoice(const PendingPlay& play)
+{
+    const Sound* sound = play.sound.get();
+    SoLoud::AudioSource& source = *play.sound->m_sound;
+    bool looping = (source.mFlags & SoLoud::AudioSource::SHOULD_LOOP) != 0;
+
+    // a one shot out of range would be silent from its first sample, a loop starts paused
+    bool culled = play.positional && glm::distance(play.position, GetListenerPosition()) >= m_maxDistance;
+    if (culled && !looping)
+    {
+        return;
+    }
+
+    // the oldest instance makes room for the new one
+    if (sound->m_maxInstances > 0)
+    {
+        int instanceCount = static_cast<int>(std::count_if(m_voices.begin(), m_voices.end(),
+            [&](const Voice& voice) { return voice.sound == sound; }));
+        if (instanceCount >= sound->m_maxInstances)
+        {
+            StealVoice(sound, sound->m_priority);
+        }
+    }
+
+    if (static_cast<int>(m_voices.size()) >= m_maxVoices && !StealVoice(nullptr, sound->m_priority))
+    {
+        return;
+    }
+
+    // volume and pause state are set by the play call itself
+    MixBus& mixBus = GetMixBus(sound->m_bus);
+    unsigned int handle;
+    if (play.positional)
+    {
+        // the attenuation is read from the source when the voice starts
+        source.set3dMinMaxDistance(m_minDistance, m_maxDistance);
+        source.set3dAttenuation(SoLoud::AudioSource::LINEAR_DISTANCE, 1.f);
+        handle = mixBus.bus->play3d(source, play.position.x, play.position.y, 0.f, 0.f, 0.f, 0.f, play.volume, play.paused || culled);
+    }
+    else
+    {
+        handle = mixBus.bus->play(source, play.volume, 0.f, play.paused);
+    }
+    m_SoloudPlayer->addVoiceToGroup(mixBus.group, handle);
+
+    // the length is known on the game side, the handle is not queried before the sound should be over
+    double endTime = looping ? std::numeric_limits<double>::infinity() : GetTime() + play.sound->GetLength();
+    float volume = play.volume < 0.f ? source.mVolume : play.volume;
+    m_voices.push_back({ play.id, handle, sound, sound->m_priority, play.startTime, play.positional, play.position, false, sound->m_bus,
+        looping, play.paused, culled, endTime, volume });
+}
+
+SoundPlayer::MixBus& SoundPlayer::GetMixBus(SoundBus bus)
+{
+    return m_buses[static_cast<int>(bus)];
+}
+
+SoundPlayer::PendingPlay* SoundPlayer::FindPendingPlay(unsigned int id)
+{
+    for (auto& play : m_pendingPlays)
+    {
+        if (play.id == id && !play.cancelled)
+        {
+            return &play;
+        }
+    }
+    return nullptr;
+}
+
+void SoundPlayer::Update3dAudio()
+{
+    PROFILE_SCOPE("SoundPlayer::Update3dAudio");
+
+    // the 3d parameters are stored without the audio thread lock, update3dAudio applies them all at once
+    glm::vec2 listener = GetListenerPosition();
+    m_SoloudPlayer->set3dListenerParameters(listener.x, listener.y, 0.f, 0.f, 0.f, -1.f, 0.f, 1.f, 0.f);
+
+    // SoLoud mixes every voice under the active voice count, even silent ones, so out of range
+    // voices are culled here: one shots are stopped, loops paused until they come back
+    bool positional = false;
+    for (size_t i = 0; i < m_voices.size();)
+    {
+        Voice& voice = m_voices[i];
+        if (!voice.positional)
+        {
+            i++;
+            continue;
+        }
+
+        bool outOfRange = glm::distance(voice.position, listener) >= m_maxDistance;
+        if (outOfRange && !voice.looping)
+        {
+            m_SoloudPlayer->stop(voice.handle);
+            m_voices.erase(m_voices.begin() + i);
+            continue;
+        }
+        if (outOfRange != voice.culled)
+        {
+            voice.culled = outOfRange;
+            if (!voice.paused)
+            {
+                m_SoloudPlayer->setPause(voice.handle, voice.culled);
+            }
+        }
+
+        positional = true;
+        if (voice.moved)
+        {
+            m_SoloudPlayer->set3dSourcePosition(voice.handle, voice.position.x, voice.position.y, 0.f);
+            voice.moved = false;
+        }
+        i++;
+    }
+
+    if (positional)
+    {
+        m_SoloudPlayer->update3dAudio();
+    }
+}
+
+glm::vec2 SoundPlayer::GetListenerPosition() const
+{
+    if (!m_listener)
+    {
+        return glm::vec2(0.f);
+    }
+
+    // the center of the view, the frustum is relative to the camera position
+    const OrthoFrustum& frustum = m_listener->GetCameraFrustum();
+    glm::vec3 position = m_listener->GetPosition();
+    return glm::vec2(position.x + (frustum.left + frustum.right) * 0.5f, position.y + (frustum.top + frustum.bottom) * 0.5f);
+}
+
+void SoundPlayer::ReclaimVoices()
+{
+    PROFILE_SCOPE("SoundPlayer::ReclaimVoices");
+
+    // each handle check takes the audio thread lock, so a one shot is only checked once it should be over,
+    // a paused one is checked again a bit later. Loops and sounds freed while playing are caught by the
+    // cursor, which checks one voice per update whatever its expected end
+    if (m_reclaimCursor >= m_voices.size())
+    {
+        m_reclaimCursor = 0;
+    }
+    double now = GetTime();
+    size_t cursor = m_reclaimCursor;
+    size_t kept = 0;
+    for (size_t i = 0; i < m_voices.size(); i++)
+    {
+        Voice& voice = m_voices[i];
+        bool valid = true;
+        if (now >= voice.endTime || i == cursor)
+        {
+            valid = m_SoloudPlayer->isValidVoiceHandle(voice.handle);
+            if (valid && now >= voice.endTime)
+            {
+                voice.endTime = now + RECLAIM_RECHECK_DELAY;
+            }
+        }
+        if (i == cursor)
+        {
+            m_reclaimCursor = valid ? kept + 1 : kept;
+        }
+        if (valid)
+        {
+            m_voices[kept++] = voice;
+        }
+    }
+    m_voices.resize(kept);
+}
+
+void SoundPlayer::ReadVoiceVolumes()
+{
+    if (m_volumesRead)
+    {
+        return;
+    }
+    m_volumesRead = true;
+
+    for (auto& voice : m_voices)
+    {
+        voice.volume = m_SoloudPlayer->getOverallVolume(voice.handle);
+    }
+}
+
+bool SoundPlayer::StealVoice(const Sound* sound, int priority)
+{
+    PROFILE_SCOPE("SoundPlayer::StealVoice");
+
+    // lowest priority first, then the quietest, then the oldest
+    ReadVoiceVolumes();
+    auto victim = m_voices.end();
+    for (auto it = m_voices.begin(); it != m_voices.end(); it++)
+    {
+        if ((sound && it->sound != sound) || it->priority > priority)
+        {
+            continue;
+        }
+
+        if (victim == m_voices.end() || it->priority < victim->priority
+            || (it->priority == victim->priority && (it->volume < victim->volume
+            || (it->volume == victim->volume && it->startTime < victim->startTime))))
+        {
+            victim = it;
+        }
+    }
+
+    if (victim == m_voices.end())
+    {
+        return false;
+    }
+    m_SoloudPlayer->stop(victim->handle);
+    m_voices.erase(victim);
+    return true;
+}
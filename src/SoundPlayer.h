@@ -1,31 +1,65 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
+#include <glm/glm.hpp>
 
 #include "SingletonDclp.h"
 #include "Config.h"
+#include "Sound.h"
 
 namespace SoLoud
 {
 	class Soloud;
+	class Bus;
+	class DuckFilter;
 }
 
-class Sound;
+class Camera;
+
+/**
+ * @brief Settings of the audio engine, see SoundPlayer::Init.
+ */
+struct SoundPlayerConfig
+{
+	bool nullDriver = false;		///< True to mix without an audio device, the mixer is then driven by SoundPlayer::Mix.
+	unsigned int sampleRate = 0;	///< Samples per second, 0 for the default of the backend.
+	unsigned int bufferSize = 0;	///< Samples mixed at once, 0 for the default of the backend.
+	unsigned int channels = 2;		///< Output channels.
+	int maxVoices = 32;				///< Sounds playing at once, see SoundPlayer::SetMaxVoices.
+};
 
 /**
  * @class SoundPlayer
  * @brief Manages the playback of sound effects and music.
  *
  * This class implements the Singleton pattern to ensure only one instance is used throughout the application.
+ *
+ * The number of sounds playing at once is limited. When every voice is taken, a new sound takes the
+ * voice of the lowest priority sound, the quietest then the oldest, or is not played if every voice
+ * has a higher priority. Sounds can also limit their own instances and set a cooldown, see Sound.
+ *
+ * Commands are queued and sent to the audio engine once per frame by Update, each SoLoud call
+ * taking the audio thread lock. A sound triggered several times in a frame plays once, and
+ * the commands on a voice in a frame are merged, the last volume and pause state winning.
+ *
+ * Sounds played with PlayAt have a world position. Their volume fades with the distance to the
+ * center of the listener camera view and they are panned by their horizontal offset from it. The
+ * positions and the listener are sent to the audio engine together, once per frame.
+ *
+ * Every sound plays through a mix bus, see SoundBus and Sound::SetBus. The volume, fades, pause
+ * and stop of a bus apply to all its sounds in a single call, whatever their number, and a bus
+ * can be ducked while another one plays.
  */
 class SoundPlayer : public SingletonDclp<SoundPlayer>
 {
 public:
 	/**
 	 * @brief Initializes the sound player.
+	 * @param config The settings of the audio engine, the defaults open the audio device.
 	 */
-	void Init();
+	void Init(const SoundPlayerConfig& config = SoundPlayerConfig());
 
 	/**
 	 * @brief Deinitializes the sound player and releases resources.
@@ -37,10 +71,101 @@ public:
 	 * @param sound A shared pointer to the sound to play.
 	 * @return An unsigned integer handle to the playing sound.
 	 * 
-	 * Just ignore the handle if the sound doesn't need to be tuned after
+	 * Just ignore the handle if the sound doesn't need to be tuned after.
+	 * The sound starts at the next Update, the handle can be used right away. Playing a sound
+	 * already triggered in this frame returns the same handle. Returns 0 when the sound is in its cooldown.
+	 * A sound still loading in the background stays queued until it is ready, see SetLoadWait.
 	 */
 	unsigned int Play(std::shared_ptr<Sound> sound);
 
+	/**
+	 * @brief Plays a sound at a world position.
+	 * @param sound A shared pointer to the sound to play.
+	 * @param position The position of the sound, in the coordinates of the camera view.
+	 * @return An unsigned integer handle to the playing sound.
+	 *
+	 * Queued like Play. A sound that does not loop and starts beyond the maximum distance would
+	 * not be heard, it is dropped without taking a voice. See SetAttenuation.
+	 */
+	unsigned int PlayAt(std::shared_ptr<Sound> sound, const glm::vec2& position);
+
+	/**
+	 * @brief Moves a sound played with PlayAt.
+	 * @param handle The handle of the playing sound.
+	 * @param position The new position of the sound.
+	 */
+	void SetPosition(unsigned int handle, const glm::vec2& position);
+
+	/**
+	 * @brief Sets the camera the positional sounds are heard from.
+	 * @param camera The camera, nullptr to listen from the origin.
+	 */
+	void SetListener(const std::shared_ptr<Camera>& camera);
+
+	/**
+	 * @brief Sets how the positional sounds fade with the distance to the listener.
+	 * @param minDistance Distance under which the sound plays at full volume, 200 by default.
+	 * @param maxDistance Distance from which the sound is silent, 1500 by default.
+	 *
+	 * The volume falls linearly between the two. Beyond the maximum distance a sound is not mixed:
+	 * a looping sound is paused until it comes back in range, any other sound is stopped.
+	 */
+	void SetAttenuation(float minDistance, float maxDistance);
+
+	/**
+	 * @brief Sends the commands queued in the frame and forgets the voices that finished playing. Called by the game once per frame.
+	 *
+	 * A sound that gets no voice, every voice having a higher priority, is dropped.
+	 */
+	void Update();
+
+	/**
+	 * @brief Sets the number of sounds that can play at once.
+	 * @param maxVoices The voice count, 32 by default, at most 251: the buses take 4 of the 255 voices the audio engine mixes.
+	 */
+	void SetMaxVoices(int maxVoices);
+
+	/**
+	 * @brief Sets how long a played sound waits for its background load.
+	 * @param seconds The wait, 0.5 by default. 0 skips sounds that are not ready, a negative wait never gives up.
+	 *
+	 * A sound played too late is out of sync with what triggered it, so it is dropped past the wait.
+	 */
+	void SetLoadWait(float seconds);
+
+	/**
+	 * @brief Mixes the playing sounds into a buffer. Only for a player initialized with the null driver.
+	 * @param buffer The interleaved output, sampleCount times the channel count floats.
+	 * @param sampleCount The number of samples per channel.
+	 *
+	 * Used to measure the mixer on machines with no audio device.
+	 */
+	void Mix(float* buffer, unsigned int sampleCount);
+
+	/**
+	 * @brief Gets the sample rate of the audio engine.
+	 * @return The samples per second.
+	 */
+	unsigned int GetSampleRate() const;
+
+	/**
+	 * @brief Gets the number of samples the audio engine mixes at once.
+	 * @return The buffer size in samples per channel.
+	 */
+	unsigned int GetBufferSize() const;
+
+	/**
+	 * @brief Gets the number of output channels.
+	 * @return The channel count.
+	 */
+	unsigned int GetChannelCount() const;
+
+	/**
+	 * @brief Gets the number of sounds playing.
+	 * @return The voice count, paused sounds included.
+	 */
+	size_t GetVoiceCount() const;
+
 	/**
 	 * @brief Sets the volume of a playing sound.
 	 * @param handle The handle of the playing sound.
@@ -67,7 +192,9 @@ public:
 	void Stop(unsigned int handle);
 
 	/**
-	 * @brief Pauses all playing sounds.
+	 * @brief Pauses all playing sounds, by pausing every bus.
+	 *
+	 * Sounds started while paused wait with their bus.
 	 */
 	void PauseAll();
 
@@ -78,13 +205,193 @@ public:
 
 
 	/**
-	 * @brief Resumes all paused sounds.
+	 * @brief Resumes the buses paused by PauseAll or PauseBus. Sounds paused one by one stay paused.
 	 */
 	void ResumeAll();
 
+	/**
+	 * @brief Sets the volume of a bus.
+	 * @param bus The bus.
+	 * @param volume The volume level, 1.0f by default.
+	 * @param fadeTime The seconds the volume takes to reach the level, 0 to set it now.
+	 */
+	void SetBusVolume(SoundBus bus, float volume, float fadeTime = 0.f);
+
+	/**
+	 * @brief Gets the volume of a bus.
+	 * @param bus The bus.
+	 * @return The volume level last set, reached at the end of a fade.
+	 */
+	float GetBusVolume(SoundBus bus) const;
+
+	/**
+	 * @brief Pauses every sound of a bus.
+	 * @param bus The bus.
+	 */
+	void PauseBus(SoundBus bus);
+
+	/**
+	 * @brief Resumes the sounds of a paused bus.
+	 * @param bus The bus.
+	 */
+	void ResumeBus(SoundBus bus);
+
+	/**
+	 * @brief Stops every sound of a bus, including the ones queued in this frame.
+	 * @param bus The bus.
+	 */
+	void StopBus(SoundBus bus);
+
+	/**
+	 * @brief Lowers a bus while another bus plays, such as the music under the voices.
+	 * @param trigger The bus that is listened to.
+	 * @param target The bus lowered, it listens to one bus at a time.
+	 * @param level The volume of the target while the trigger plays.
+	 * @param attack The seconds the target takes to go down.
+	 * @param release The seconds the target takes to come back once the trigger is silent.
+	 *
+	 * The audio engine follows the trigger output while mixing, no call is needed per frame.
+	 */
+	void SetDucking(SoundBus trigger, SoundBus target, float level, float attack = 0.1f, float release = 0.5f);
+
+	/**
+	 * @brief Stops ducking a bus.
+	 * @param target The bus lowered by SetDucking.
+	 */
+	void ClearDucking(SoundBus target);
+
 private:
+	/**
+	 * @brief A playing sound.
+	 */
+	struct Voice
+	{
+		unsigned int id;		///< The handle returned by Play.
+		unsigned int handle;	///< The SoLoud handle of the playing sound.
+		const Sound* sound;		///< The sound played, only compared.
+		int priority;			///< The priority of the sound.
+		double startTime;		///< Time the sound started, in seconds.
+		bool positional;		///< True for a sound played with PlayAt.
+		glm::vec2 position;		///< The position of a positional sound.
+		bool moved;				///< True when the position changed since the last update.
+		SoundBus bus;			///< The bus the sound plays through.
+		bool looping;			///< True for a looping sound, paused instead of stopped out of range.
+		bool paused;			///< True when paused by Pause.
+		bool culled;			///< True when paused for being out of range.
+		double endTime;			///< Time a one shot is expected to end, its handle is only checked after it.
+		float volume;			///< The overall volume, read at most once per update for voice stealing.
+	};
+
+	/**
+	 * @brief A sound to start at the next Update, or once loaded.
+	 */
+	struct PendingPlay
+	{
+		unsigned int id;				///< The handle returned by Play.
+		std::shared_ptr<Sound> sound;	///< The sound, kept alive until it starts.
+		float volume;					///< The volume, negative for the volume of the sound.
+		bool paused;					///< True to start paused.
+		bool cancelled;					///< True when stopped before it started.
+		double startTime;				///< Time Play was called, in seconds.
+		bool positional = false;		///< True for a sound played with PlayAt.
+		glm::vec2 position = glm::vec2(0.f);	///< The position of a positional sound.
+	};
+
+	/**
+	 * @brief A mix bus, playing in the audio engine for the lifetime of the player.
+	 */
+	struct MixBus
+	{
+		std::shared_ptr<SoLoud::DuckFilter> ducking;	///< The filter lowering the bus, nullptr when not ducked. Outlives the bus.
+		std::shared_ptr<SoLoud::Bus> bus;				///< The bus the voices are played through.
+		unsigned int handle = 0;						///< The handle of the bus voice.
+		unsigned int group = 0;							///< The voice group of the sounds of the bus.
+		float volume = 1.f;								///< The volume last set.
+		SoundBus duckTrigger = SoundBus::COUNT;			///< The bus listened to when ducked.
+		int duckListeners = 0;							///< Number of buses ducked by this one.
+	};
+
+	/**
+	 * @brief The commands on a playing voice queued in a frame.
+	 */
+	struct PendingCommand
+	{
+		float volume = 1.f;		///< The volume to set.
+		bool hasVolume = false;	///< True if the volume was set.
+		int pause = -1;			///< 1 to pause, 0 to resume, -1 to leave as is.
+		bool stop = false;		///< True to stop the voice.
+	};
+
+	/**
+	 * @brief Sends the queued commands and starts the queued sounds.
+	 */
+	void FlushCommands();
+
+	/**
+	 * @brief Starts a queued sound, taking a voice if none is free.
+	 * @param play The queued sound.
+	 */
+	void StartVoice(const PendingPlay& play);
+
+	/**
+	 * @brief Finds a sound queued in this frame.
+	 * @param id The handle returned by Play.
+	 * @return The queued sound, nullptr if it is not queued.
+	 */
+	PendingPlay* FindPendingPlay(unsigned int id);
+
+	/**
+	 * @brief Gets a mix bus.
+	 * @param bus The bus.
+	 * @return The bus state.
+	 */
+	MixBus& GetMixBus(SoundBus bus);
+
+	/**
+	 * @brief Sends the listener and the moved sounds to the audio engine and updates every positional voice at once.
+	 *
+	 * Also culls the positional voices out of range, see SetAttenuation.
+	 */
+	void Update3dAudio();
+
+	/**
+	 * @brief Gets the position the positional sounds are heard from.
+	 * @return The center of the listener camera view.
+	 */
+	glm::vec2 GetListenerPosition() const;
+
+	/**
+	 * @brief Removes the voices that finished playing.
+	 */
+	void ReclaimVoices();
+
+	/**
+	 * @brief Reads the overall volume of every voice, once per update.
+	 */
+	void ReadVoiceVolumes();
+
+	/**
+	 * @brief Stops a voice to make room for a new sound.
+	 * @param sound The sound to steal an instance of, nullptr for any sound.
+	 * @param priority The priority of the new sound, only voices of lower or equal priority are taken.
+	 * @return True if a voice was stopped.
+	 */
+	bool StealVoice(const Sound* sound, int priority);
+
 	std::shared_ptr<SoLoud::Soloud> m_SoloudPlayer;		///< The sound engine player.
-	std::vector<int> m_handles;							///< Handles to currently playing sounds.
+	std::vector<Voice> m_voices;						///< Currently playing sounds.
+	size_t m_reclaimCursor = 0;							///< Next voice checked whatever its expected end, one per update.
+	bool m_volumesRead = false;							///< True when the voice volumes were read in this update.
+	MixBus m_buses[static_cast<int>(SoundBus::COUNT)];	///< The mix buses, by SoundBus.
+	int m_maxVoices = 32;								///< Number of sounds that can play at once.
+	std::shared_ptr<Camera> m_listener;					///< The camera the positional sounds are heard from.
+	float m_minDistance = 200.f;						///< Distance of the full volume.
+	float m_maxDistance = 1500.f;						///< Distance of silence.
+	float m_loadWait = 0.5f;							///< Seconds a play waits for its sound to load, negative for no limit.
+	unsigned int m_nextId = 1;							///< Next handle returned by Play.
+	std::vector<PendingPlay> m_pendingPlays;			///< Sounds to start at the next Update, and the ones waiting for their load.
+	std::unordered_map<const Sound*, size_t> m_pendingSounds;				///< Index of each queued sound in m_pendingPlays.
+	std::unordered_map<unsigned int, PendingCommand> m_pendingCommands;		///< Commands on playing voices by handle.
 };
 
 /**
@@ -1,6 +1,7 @@
 #include "SpriteAnimation.h"
 #include "ResourceManager.h"
 #include "IDGenerator.h"
+#include "SpriteSheet.h"
 
 SpriteAnimation::SpriteAnimation(const std::shared_ptr<Texture> texture, float frameTime, int frameCount) :
 	m_frameCount(frameCount), m_secondBtFrame(frameTime)
@@ -27,6 +28,20 @@ SpriteAnimation::SpriteAnimation(const std::shared_ptr<Mesh> mesh, const std::sh
 	m_objectType = "animation";
 }
 
+SpriteAnimation::SpriteAnimation(const std::shared_ptr<SpriteSequence> sequence) :
+	m_frameCount(static_cast<GLuint>(sequence->frames.size())), m_secondBtFrame(sequence->frameTime)
+{
+	m_objectId = getUniqueID();
+	m_sequence = sequence;
+	m_texture = sequence->frames.front().texture;
+	m_mesh = ResourceManager::GetInstance()->GetMesh("quad_center.nfg");
+	m_repeat = true;
+	m_done = false;
+	m_timeSinceLastFrame = 0.f;
+	m_currentFrame = 0;
+	m_objectType = "animation";
+}
+
 void SpriteAnimation::Update(GLfloat deltaTime)
 {
 	m_timeSinceLastFrame += deltaTime;
@@ -39,6 +54,12 @@ void SpriteAnimation::Update(GLfloat deltaTime)
 		}
 		m_currentFrame %= m_frameCount;
 		m_timeSinceLastFrame = 0.f;
+
+		// the renderer binds the frame's page and sends its rect
+		if (m_sequence)
+		{
+			m_texture = m_sequence->frames[m_currentFrame].texture;
+		}
 	}
 }
 
@@ -49,12 +70,13 @@ void SpriteAnimation::SetRepeat(bool repeat)
 
 void SpriteAnimation::SendUniformData(std::map<std::string, GLint>& uniformLocationData)
 {
+	// an atlas frame is a whole image, the sheet math of the shader is turned off
 	if (uniformLocationData["currentFrame"] != -1)
 	{
-		glUniform1f(uniformLocationData["currentFrame"], static_cast<GLfloat>(this->GetCurrentFrameIndex()));
+		glUniform1f(uniformLocationData["currentFrame"], m_sequence ? 0.f : static_cast<GLfloat>(this->GetCurrentFrameIndex()));
 	}
 	if (uniformLocationData["frameCount"] != -1)
 	{
-		glUniform1f(uniformLocationData["frameCount"], static_cast<GLfloat>(this->GetNumFrames()));
+		glUniform1f(uniformLocationData["frameCount"], m_sequence ? 1.f : static_cast<GLfloat>(this->GetNumFrames()));
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "BaseObject.h"
 
+struct SpriteSequence;
+
 /**
  * @class SpriteAnimation
  * @brief Represents an animated sprite object.
@@ -27,6 +29,15 @@ public:
 	 */
 	SpriteAnimation(const std::shared_ptr<Mesh> mesh, const std::shared_ptr<Texture> texture, float frameTime, int frameCount);
 
+	/**
+	 * @brief Constructs a SpriteAnimation object playing an animation of a prebuilt atlas.
+	 * @param sequence The animation, see ResourceManager::GetSpriteSequence.
+	 *
+	 * Each frame is a separate atlas image, so the frames can be laid out in any order
+	 * and over several rows or pages.
+	 */
+	SpriteAnimation(const std::shared_ptr<SpriteSequence> sequence);
+
 	/**
 	 * @brief Gets the number of frames in the animation.
 	 * @return The number of frames.
@@ -74,4 +85,5 @@ private:
 	GLfloat m_secondBtFrame;		///< The time duration between frames.
 	GLfloat m_timeSinceLastFrame;	///< The time elapsed since the last frame update.
 	bool m_repeat;					///< Indicates if the animation should repeat.
+	std::shared_ptr<SpriteSequence> m_sequence;	///< The atlas animation, nullptr for a single row sprite sheet.
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class Texture;
+
+/**
+ * @struct SpriteFrame
+ * @brief An image of a prebuilt atlas, see ResourceManager::LoadAtlas.
+ *
+ * The atlas builder crops transparent borders, the offset and source size give
+ * back the place of the kept pixels in the original image.
+ */
+struct SpriteFrame
+{
+	std::shared_ptr<Texture> texture;	///< The frame, binds its atlas page.
+	glm::vec2 size;						///< Size of the kept pixels.
+	glm::vec2 sourceSize;				///< Size of the original image.
+	glm::vec2 offset;					///< Top left of the kept pixels in the original image.
+	glm::vec2 pivot;					///< Pivot relative to the original image, (0.5, 0.5) is its center.
+};
+
+/**
+ * @struct SpriteSequence
+ * @brief The frames of an animation of a prebuilt atlas, played by SpriteAnimation.
+ */
+struct SpriteSequence
+{
+	std::vector<SpriteFrame> frames;	///< The frames in play order. They share the same size and offset.
+	float frameTime;					///< Time of a frame in seconds.
+};
\ No newline at end of file
@@ -1,79 +1,124 @@
 #include "Text.h"
+#include <algorithm>
 #include <string>
 #include <glad/glad.h>
 #include "Config.h"
-#include "ResourceManager.h"
+#include "GlyphCache.h"
+#include "Mesh.h"
 #include "Logger.h"
 #include "IDGenerator.h"
+#include "Profiler.h"
+#include "ResourceManager.h"
+
+// distance fields are rasterized at this size, then scaled
+static const int DISTANCE_FIELD_FONT_SIZE = 48;
+
+// reads one UTF-8 sequence, invalid bytes are read as Latin-1
+static Uint32 DecodeUTF8(const std::string& text, size_t& position)
+{
+	unsigned char lead = static_cast<unsigned char>(text[position++]);
+	int length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+	Uint32 codepoint = length == 3 ? lead & 0x07 : length == 2 ? lead & 0x0F : length == 1 ? lead & 0x1F : lead;
+	if (length == 0 || position + length > text.size())
+	{
+		return lead;
+	}
 
-Text::Text(const std::string& text, const std::string& fontPath, int fontSize, const SDL_Color& color, int filtermode) :
-	BaseObject(nullptr, nullptr), m_text(text), m_fontPath(fontPath), m_fontSize(fontSize), m_color(color), m_filterMode(filtermode)
+	for (int i = 0; i < length; i++)
+	{
+		unsigned char next = static_cast<unsigned char>(text[position + i]);
+		if ((next & 0xC0) != 0x80)
+		{
+			return lead;
+		}
+		codepoint = (codepoint << 6) | (next & 0x3F);
+	}
+	position += length;
+	return codepoint;
+}
+
+std::vector<Text*> Text::s_dirtyTexts;
+
+Text::Text(const std::string& text, const std::string& fontPath, int fontSize, const SDL_Color& color, int filtermode, bool distanceField) :
+	BaseObject(nullptr, nullptr), m_text(text), m_fontPath(fontPath), m_fontSize(fontSize), m_color(color), m_filterMode(filtermode),
+	m_distanceField(distanceField), m_baseFontSize(fontSize), m_layoutSize(0.f), m_fontNeedUpdate(false), m_queued(false)
 {
 	m_objectId = getUniqueID();
-	std::string path_to_font = ResourcesPath::FONT + fontPath;
-	m_font = TTF_OpenFont(path_to_font.c_str(), m_fontSize);
+	OpenFont();
 	if (!m_font)
 	{
-		LogError("Error loading font: %s", m_font);
 		return;
 	}
-	m_mesh = ResourceManager::GetInstance()->GetMesh("quad_center.nfg");
-	if (!m_mesh)
-	{
-		ResourceManager::GetInstance()->LoadMesh("quad_center.nfg");
-		m_mesh = ResourceManager::GetInstance()->GetMesh("quad_center.nfg");
-	}
+	m_mesh = std::make_shared<Mesh>();
+	m_texture = std::make_shared<Texture>();
 
 	m_needCalculateWorldMatrix = true;
 	m_textNeedUpdate = true;
 	m_objectType = "text";
 
-	UpdateText();
+	ApplyFilterMode();
+	MarkDirty();
 }
 
-Text::Text(const std::string& text, TTF_Font* font, int fontSize, const SDL_Color& color, int filtermode) :
-	BaseObject(nullptr, nullptr), m_text(text), m_fontSize(fontSize), m_color(color), m_filterMode(filtermode), m_font(font)
+Text::Text(const std::string& text, TTF_Font* font, int fontSize, const SDL_Color& color, int filtermode, bool distanceField) :
+	BaseObject(nullptr, nullptr), m_text(text), m_fontSize(fontSize), m_color(color), m_filterMode(filtermode),
+	m_distanceField(distanceField), m_baseFontSize(fontSize), m_layoutSize(0.f), m_fontNeedUpdate(false), m_queued(false), m_font(font)
 {
 	m_objectId = getUniqueID();
-	m_mesh = ResourceManager::GetInstance()->GetMesh("quad_center.nfg");
-	if (!m_mesh)
-	{
-		ResourceManager::GetInstance()->LoadMesh("quad_center.nfg");
-		m_mesh = ResourceManager::GetInstance()->GetMesh("quad_center.nfg");
-	}
+	m_mesh = std::make_shared<Mesh>();
+	m_texture = std::make_shared<Texture>();
 
 	m_needCalculateWorldMatrix = true;
 	m_textNeedUpdate = true;
 	m_objectType = "text";
 
-	UpdateText();
+	ApplyFilterMode();
+	MarkDirty();
 }
 
 Text::~Text()
 {
 	m_texture = nullptr;
 	m_mesh = nullptr;
+	CloseFont();
+
+	if (m_queued)
+	{
+		s_dirtyTexts.erase(std::find(s_dirtyTexts.begin(), s_dirtyTexts.end(), this));
+	}
 }
 
 void Text::SetText(const std::string& newText)
 {
+	if (newText == m_text)
+	{
+		return;
+	}
 	m_text = newText;
-	m_textNeedUpdate = true;
-	UpdateText();
+	MarkDirty();
 }
 
 void Text::SetFontSize(int fontSize)
 {
+	if (fontSize == m_fontSize)
+	{
+		return;
+	}
 	m_fontSize = fontSize;
-	m_textNeedUpdate = true;
-	UpdateText();
+	if (m_distanceField)
+	{
+		ApplyFontScale();
+		return;
+	}
+	// the font is reopened once the size is final
+	m_fontNeedUpdate = !m_fontPath.empty();
+	MarkDirty();
 }
 
 void Text::SetColor(const SDL_Color& color)
 {
+	// applied in the shader, the glyphs stay as they are
 	m_color = color;
-	m_textNeedUpdate = true;
-	UpdateText();
 }
 
 void Text::SetFilterMode(int filtermode)
@@ -81,16 +126,28 @@ void Text::SetFilterMode(int filtermode)
 	if (filtermode == GL_LINEAR || filtermode == GL_NEAREST)
 	{
 		m_filterMode = filtermode;
-		m_textNeedUpdate = true;
+		ApplyFilterMode();
 	}
-	UpdateText();
 }
 
 void Text::SetFont(TTF_Font* font)
 {
+	if (font == m_font)
+	{
+		return;
+	}
+	CloseFont();
+	m_fontPath.clear();
 	m_font = font;
-	m_textNeedUpdate = true;
-	UpdateText();
+	m_baseFontSize = m_fontSize;
+	m_fontNeedUpdate = false;
+	ApplyFilterMode();
+	MarkDirty();
+}
+
+bool Text::IsDistanceField() const
+{
+	return m_distanceField;
 }
 
 const std::string& Text::GetText() const
@@ -98,8 +155,41 @@ const std::string& Text::GetText() const
 	return m_text;
 }
 
+bool Text::IsDirty() const
+{
+	return m_textNeedUpdate || m_fontNeedUpdate;
+}
+
+void Text::UpdateDirtyTexts()
+{
+	if (s_dirtyTexts.empty())
+	{
+		return;
+	}
+
+	PROFILE_SCOPE("Text::UpdateDirtyTexts");
+
+	// the glyphs missing from every text are rasterized in one batch, then the quads are rebuilt
+	std::vector<Text*> texts;
+	texts.swap(s_dirtyTexts);
+	for (Text* text : texts)
+	{
+		text->m_queued = false;
+		text->RequestGlyphs();
+	}
+	GlyphCache::RasterizeRequested();
+	for (Text* text : texts)
+	{
+		text->UpdateText();
+	}
+}
+
 void Text::UpdateText()
 {
+	PROFILE_SCOPE("Text::UpdateText");
+
+	ApplyFontChange();
+
 	if (m_needCalculateWorldMatrix)
 	{
 		RecalculateWorldMatrix();
@@ -112,59 +202,182 @@ void Text::UpdateText()
 
 	if (m_font == nullptr || m_mesh == nullptr)
 	{
-		LogError("Error create text texture: font or mesh is null");
+		LogError("Error create text mesh: font or mesh is null");
 		return;
 	}
 
-	SDL_Surface* textSurface = TTF_RenderText_Blended_Wrapped(m_font, m_text.c_str(), m_color, 0);
-	if (textSurface == nullptr) 
+	GlyphCache* glyphCache = GlyphCache::Get(m_font, m_distanceField);
+	std::vector<Vertex>& vertices = m_mesh->m_vertices;
+	std::vector<GLuint>& indices = m_mesh->m_indices;
+	std::vector<MeshRange>& ranges = m_mesh->m_ranges;
+	vertices.clear();
+	indices.clear();
+	ranges.clear();
+
+	// the quads are grouped by atlas page, each page is one run of indices drawn with its own bind
+	std::vector<std::pair<std::shared_ptr<Texture>, std::vector<GLuint>>> pageIndices;
+
+	// lay the glyphs out in pixels, the top left of the first line at the origin
+	int penX = 0, lineTop = 0, width = 0;
+	Uint32 previous = 0;
+	for (size_t position = 0; position < m_text.size();)
 	{
-		LogError("Rendering font error: %s", TTF_GetError());
-		return;
+		Uint32 codepoint = DecodeUTF8(m_text, position);
+		if (codepoint == '\n')
+		{
+			width = std::max(width, penX);
+			penX = 0;
+			lineTop += glyphCache->GetLineSkip();
+			previous = 0;
+			continue;
+		}
+
+		const Glyph* glyph = glyphCache->GetGlyph(codepoint);
+		if (!glyph)
+		{
+			previous = 0;
+			continue;
+		}
+		if (previous != 0)
+		{
+			penX += glyphCache->GetKerning(previous, codepoint);
+		}
+
+		if (glyph->image)
+		{
+			std::shared_ptr<Texture> page = glyph->image->GetAtlasPage();
+			auto pageIt = std::find_if(pageIndices.begin(), pageIndices.end(),
+				[&page](const std::pair<std::shared_ptr<Texture>, std::vector<GLuint>>& entry) { return entry.first == page; });
+			if (pageIt == pageIndices.end())
+			{
+				pageIndices.emplace_back(page, std::vector<GLuint>());
+				pageIt = pageIndices.end() - 1;
+			}
+
+			const glm::vec4& uvRect = glyph->image->GetUVRect();
+			float x0 = static_cast<float>(penX + glyph->offsetX);
+			float x1 = x0 + glyph->width;
+			float y0 = static_cast<float>(lineTop + glyph->offsetY);
+			float y1 = y0 + glyph->height;
+
+			// same winding and UV orientation as quad_center.nfg
+			GLuint first = static_cast<GLuint>(vertices.size());
+			vertices.push_back({ glm::vec3(x0, y0, 0.f), glm::vec2(uvRect.x, uvRect.y) });
+			vertices.push_back({ glm::vec3(x0, y1, 0.f), glm::vec2(uvRect.x, uvRect.w) });
+			vertices.push_back({ glm::vec3(x1, y1, 0.f), glm::vec2(uvRect.z, uvRect.w) });
+			vertices.push_back({ glm::vec3(x1, y0, 0.f), glm::vec2(uvRect.z, uvRect.y) });
+			pageIt->second.insert(pageIt->second.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+		}
+
+		penX += glyph->advance;
+		previous = codepoint;
 	}
+	width = std::max(width, penX);
+	int height = lineTop + glyphCache->GetHeight();
 
-	if (m_texture == nullptr)
+	for (const auto& entry : pageIndices)
 	{
-		// Create a new texture
-		GLuint texture_id;
-		m_texture = std::make_shared<Texture>();
-		glGenTextures(1, &texture_id);
-		m_texture->m_iTextureID = texture_id;
-		glBindTexture(GL_TEXTURE_2D, texture_id);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_filterMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_filterMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		ranges.push_back({ entry.first, indices.size(), entry.second.size() });
+		indices.insert(indices.end(), entry.second.begin(), entry.second.end());
 	}
-	else 
+
+	// centered unit coordinates like quad_center.nfg, the size scales them to pixels
+	for (auto& vertex : vertices)
 	{
-		// Update existing texture
-		glBindTexture(GL_TEXTURE_2D, m_texture->m_iTextureID);
+		vertex.position.x = vertex.position.x / std::max(width, 1) - 0.5f;
+		vertex.position.y = vertex.position.y / height - 0.5f;
 	}
+	m_mesh->UpdateBuffers();
 
-	// temporary fix
-	Uint32 len = textSurface->w * textSurface->format->BytesPerPixel;
-	Uint8* src = static_cast<Uint8*>(textSurface->pixels);
-	Uint8* dst = static_cast<Uint8*>(textSurface->pixels);
-	for (int i = 0; i < textSurface->h; i++) 
+	// the first page is bound for the uniforms, each run binds its own page
+	if (!pageIndices.empty())
 	{
-		SDL_memmove(dst, src, len);
-		dst += len;
-		src += textSurface->pitch;
+		m_texture = pageIndices.front().first;
 	}
-	textSurface->pitch = len;
-
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textSurface->w, textSurface->h, 0, GL_BGRA, GL_UNSIGNED_BYTE, textSurface->pixels);
-	SetPosition(0.f, 0.f);
-	SetSize((float)textSurface->w, (float)textSurface->h);
-	SetRotation(0.f);
+	m_layoutSize = glm::vec2(static_cast<float>(width), static_cast<float>(height));
+	ApplyFontScale();
 
 	if (m_needCalculateWorldMatrix)
 	{
 		RecalculateWorldMatrix();
 	}
 
-	SDL_FreeSurface(textSurface);
-
 	m_textNeedUpdate = false;
 }
+
+void Text::SendUniformData(std::map<std::string, GLint>& uniformLocationData)
+{
+	if (uniformLocationData["u_color"] != -1)
+	{
+		glUniform4f(uniformLocationData["u_color"], m_color.r / 255.f, m_color.g / 255.f, m_color.b / 255.f, m_color.a / 255.f);
+	}
+}
+
+void Text::ApplyFilterMode()
+{
+	if (m_font)
+	{
+		GlyphCache::Get(m_font, m_distanceField)->SetFilter(m_filterMode == GL_NEAREST ? TextureFilterMode::NEAREST : TextureFilterMode::LINEAR);
+	}
+}
+
+void Text::OpenFont()
+{
+	// texts with the same font and size share one open font
+	m_baseFontSize = m_distanceField ? DISTANCE_FIELD_FONT_SIZE : m_fontSize;
+	m_sharedFont = RESOURCE()->AcquireFont(m_fontPath, m_baseFontSize);
+	m_font = m_sharedFont.get();
+}
+
+void Text::CloseFont()
+{
+	m_sharedFont = nullptr;
+	m_font = nullptr;
+}
+
+void Text::ApplyFontChange()
+{
+	if (!m_fontNeedUpdate)
+	{
+		return;
+	}
+	m_fontNeedUpdate = false;
+	CloseFont();
+	OpenFont();
+	ApplyFilterMode();
+}
+
+void Text::MarkDirty()
+{
+	m_textNeedUpdate = true;
+	if (!m_queued)
+	{
+		m_queued = true;
+		s_dirtyTexts.push_back(this);
+	}
+}
+
+void Text::RequestGlyphs()
+{
+	ApplyFontChange();
+	if (!m_textNeedUpdate || !m_font)
+	{
+		return;
+	}
+
+	GlyphCache* glyphCache = GlyphCache::Get(m_font, m_distanceField);
+	for (size_t position = 0; position < m_text.size();)
+	{
+		Uint32 codepoint = DecodeUTF8(m_text, position);
+		if (codepoint != '\n')
+		{
+			glyphCache->Request(codepoint);
+		}
+	}
+}
+
+void Text::ApplyFontScale()
+{
+	float scale = m_distanceField && m_baseFontSize > 0 ? static_cast<float>(m_fontSize) / m_baseFontSize : 1.f;
+	SetSize(m_layoutSize.x * scale, m_layoutSize.y * scale);
+}
@@ -3,6 +3,7 @@
 #include <memory>
 #include <SDL2/SDL_ttf.h>
 #include <string>
+#include <vector>
 #include "BaseObject.h"
 #include "Texture.h"
 
@@ -11,6 +12,11 @@
  * @brief Represents a text object that can be rendered in the game.
  *
  * This class handles the representation and management of a text object, including setting its text, font, size, color, and filter mode.
+ * The text is a mesh of glyph quads from the GlyphCache of its font, tinted by its color in the shader.
+ * Changing the string rewrites the vertices only, and changing the color rewrites nothing.
+ * Lines are broken at '\n'. The glyphs of each atlas page are one run of the mesh, drawn with one call per page.
+ * The setters only mark the text dirty: the dirty texts are rebuilt once per frame by UpdateDirtyTexts,
+ * with their missing glyphs rasterized together on the job workers.
  */
 class Text : public BaseObject
 {
@@ -22,8 +28,9 @@ public:
      * @param fontSize The size of the font.
      * @param color The color of the text. Defaults to black (0, 0, 0, 255).
      * @param filtermode The filter mode for the text texture. Defaults to GL_LINEAR.
+     * @param distanceField True to draw distance field glyphs, see IsDistanceField.
      */
-    Text(const std::string& text, const std::string& fontPath, int fontSize, const SDL_Color& color = { 0, 0, 0, 255 }, int filtermode = GL_LINEAR);
+    Text(const std::string& text, const std::string& fontPath, int fontSize, const SDL_Color& color = { 0, 0, 0, 255 }, int filtermode = GL_LINEAR, bool distanceField = false);
 
     /**
      * @brief Constructs a Text object with the specified text, font, font size, color, and filter mode.
@@ -32,8 +39,9 @@ public:
      * @param fontSize The size of the font.
      * @param color The color of the text. Defaults to black (0, 0, 0, 255).
      * @param filtermode The filter mode for the text texture. Defaults to GL_LINEAR.
+     * @param distanceField True to draw distance field glyphs, see IsDistanceField.
      */
-    Text(const std::string& text, TTF_Font* font, int fontSize, const SDL_Color& color = { 0, 0, 0, 255 }, int filtermode = GL_LINEAR);
+    Text(const std::string& text, TTF_Font* font, int fontSize, const SDL_Color& color = { 0, 0, 0, 255 }, int filtermode = GL_LINEAR, bool distanceField = false);
 
     /**
      * @brief Deleted default constructor to prevent creating an uninitialized Text object.
@@ -41,7 +49,7 @@ public:
     Text() = delete;
 
     /**
-     * @brief Destructor for the Text object.
+     * @brief Destructor for the Text object. Releases the font acquired from a font path.
      */
     ~Text();
 
@@ -54,6 +62,9 @@ public:
     /**
      * @brief Sets the font size of the text.
      * @param fontSize The new font size.
+     *
+     * Reopens the font for a text constructed from a font path. A font passed by the caller
+     * keeps its own size. A distance field text is only scaled, nothing is rasterized.
      */
     void SetFontSize(int fontSize);
 
@@ -64,8 +75,8 @@ public:
     void SetColor(const SDL_Color& color);
 
     /**
-     * @brief Sets the filter mode for the text texture.
-     * @param filtermode The new filter mode.
+     * @brief Sets the filter mode for the glyph atlas of the font.
+     * @param filtermode GL_LINEAR or GL_NEAREST. Applies to every text using the font.
      */
     void SetFilterMode(int filtermode);
 
@@ -75,6 +86,15 @@ public:
      */
     void SetFont(TTF_Font* font);
 
+    /**
+     * @brief Checks if the text draws distance field glyphs.
+     * @return True for a distance field text.
+     *
+     * Distance field glyphs are rasterized once at the size of the font (a font path is opened
+     * at 48 pt) and stay sharp at any font size or scale. They must be drawn with a TextRenderer.
+     */
+    bool IsDistanceField() const;
+
     /**
      * @brief Gets the current text being displayed.
      * @return The current text.
@@ -82,10 +102,33 @@ public:
     const std::string& GetText() const;
 
     /**
-     * @brief Updates the text texture. Automatically be called after setting new text or changing font attributes.
+     * @brief Checks if the text changed and was not laid out yet.
+     * @return True until UpdateText or UpdateDirtyTexts rebuilds it.
+     */
+    bool IsDirty() const;
+
+    /**
+     * @brief Rebuilds the glyph quads now.
+     *
+     * Setting new text or font attributes only marks the text dirty, and it is rebuilt by UpdateDirtyTexts.
+     * Call this when the size of the text is needed before the next frame.
      */
     void UpdateText();
 
+    /**
+     * @brief Rebuilds every dirty text. Called by the game once per frame, before drawing.
+     *
+     * The glyphs missing from the atlases are rasterized on the job workers, one per font,
+     * and only their atlas upload and the vertex buffers are left to the GL thread.
+     */
+    static void UpdateDirtyTexts();
+
+    /**
+     * @brief Sends the color of the text to the shader.
+     * @param uniformLocationData Map of uniform names to their locations.
+     */
+    void SendUniformData(std::map<std::string, GLint>& uniformLocationData) override;
+
 public:
     bool m_textNeedUpdate;
 
@@ -95,6 +138,49 @@ private:
     int m_fontSize;             ///< The size of the font.
     SDL_Color m_color;          ///< The color of the text.
     int m_filterMode;           ///< The filter mode for the text texture.
+    bool m_distanceField;       ///< True to draw distance field glyphs.
+    int m_baseFontSize;         ///< Size the glyphs are rasterized at.
+    glm::vec2 m_layoutSize;     ///< Size of the laid out glyphs at the base font size.
+    bool m_fontNeedUpdate;      ///< True when the font has to be reopened at the new size.
+    bool m_queued;              ///< True while the text is in the dirty list.
 
     TTF_Font* m_font = nullptr; ///< The font object.
+    std::shared_ptr<TTF_Font> m_sharedFont; ///< Reference to the font when opened from m_fontPath.
+
+    /**
+     * @brief Applies the filter mode to the glyph atlas of the font.
+     */
+    void ApplyFilterMode();
+
+    /**
+     * @brief Acquires the font at m_fontPath from the resource manager, with the current size or the distance field size.
+     */
+    void OpenFont();
+
+    /**
+     * @brief Releases the font, closed once no other text or Load holds it.
+     */
+    void CloseFont();
+
+    /**
+     * @brief Sizes the text from its layout and font size.
+     */
+    void ApplyFontScale();
+
+    /**
+     * @brief Reopens the font if the font size changed.
+     */
+    void ApplyFontChange();
+
+    /**
+     * @brief Flags the text for the next UpdateDirtyTexts.
+     */
+    void MarkDirty();
+
+    /**
+     * @brief Requests the glyphs of the text that are not in the glyph cache yet.
+     */
+    void RequestGlyphs();
+
+    static std::vector<Text*> s_dirtyTexts;  ///< Texts changed since the last UpdateDirtyTexts.
 };
\ No newline at end of file
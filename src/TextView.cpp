@@ -0,0 +1,223 @@
+#include "TextView.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include "Renderer.h"
+#include "ResourceManager.h"
+#include "Text.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+static const uint64_t NO_LINE = UINT64_MAX;
+
+TextView::TextView(const std::string& fontPath, int fontSize, size_t capacity, int visibleLineCount, const SDL_Color& color) :
+	m_fontSize(fontSize), m_lineSkip(0), m_color(color), m_capacity(std::max<size_t>(capacity, 1)), m_start(0),
+	m_appendedCount(0), m_firstVisible(0), m_followTail(true), m_visibleLineCount(0), m_x(0.f), m_y(0.f)
+{
+	m_font = RESOURCE()->AcquireFont(fontPath, fontSize);
+	if (!m_font)
+	{
+		LogError("Text view can not open font %s", fontPath.c_str());
+		return;
+	}
+	m_lineSkip = TTF_FontLineSkip(m_font.get());
+	SetVisibleLineCount(visibleLineCount);
+}
+
+TextView::~TextView()
+{
+	m_slots.clear();
+	m_font = nullptr;
+}
+
+void TextView::AppendLine(const std::string& text)
+{
+	size_t begin = 0;
+	while (true)
+	{
+		size_t end = text.find('\n', begin);
+		std::string line = text.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+
+		// the oldest line is overwritten once the buffer is full
+		if (m_lines.size() < m_capacity)
+		{
+			m_lines.push_back(std::move(line));
+		}
+		else
+		{
+			m_lines[m_start] = std::move(line);
+			m_start = (m_start + 1) % m_capacity;
+		}
+		m_appendedCount++;
+
+		if (end == std::string::npos)
+		{
+			break;
+		}
+		begin = end + 1;
+	}
+
+	if (m_followTail)
+	{
+		m_firstVisible = NO_LINE;
+	}
+	ClampScroll();
+	AssignSlots();
+}
+
+void TextView::Clear()
+{
+	std::vector<std::string>().swap(m_lines);
+	m_start = 0;
+	m_appendedCount = 0;
+	m_firstVisible = 0;
+	m_followTail = true;
+
+	// sequence numbers start over, the slots must not match the new lines
+	for (auto& slot : m_slots)
+	{
+		slot.line = NO_LINE;
+	}
+}
+
+void TextView::Scroll(int lineCount)
+{
+	if (lineCount < 0 && static_cast<uint64_t>(-static_cast<int64_t>(lineCount)) > m_firstVisible)
+	{
+		m_firstVisible = 0;
+	}
+	else
+	{
+		m_firstVisible += lineCount;
+	}
+	ClampScroll();
+	AssignSlots();
+
+	// scrolling back down to the end follows the log again
+	m_followTail = m_firstVisible + m_visibleLineCount >= m_appendedCount;
+}
+
+void TextView::ScrollToBottom()
+{
+	m_followTail = true;
+	m_firstVisible = NO_LINE;
+	ClampScroll();
+	AssignSlots();
+}
+
+void TextView::SetPosition(float x, float y)
+{
+	m_x = x;
+	m_y = y;
+}
+
+void TextView::SetVisibleLineCount(int visibleLineCount)
+{
+	m_visibleLineCount = std::max(visibleLineCount, 1);
+	if (!m_font)
+	{
+		return;
+	}
+
+	m_slots.resize(m_visibleLineCount);
+	for (auto& slot : m_slots)
+	{
+		if (!slot.text)
+		{
+			slot.text = std::make_shared<Text>("", m_font.get(), m_fontSize, m_color, GL_LINEAR);
+		}
+		slot.line = NO_LINE;
+	}
+
+	if (m_followTail)
+	{
+		m_firstVisible = NO_LINE;
+	}
+	ClampScroll();
+	AssignSlots();
+}
+
+size_t TextView::GetLineCount() const
+{
+	return m_lines.size();
+}
+
+const std::string& TextView::GetLine(size_t index) const
+{
+	static const std::string empty;
+	if (m_lines.empty())
+	{
+		return empty;
+	}
+	return m_lines[(m_start + index) % m_lines.size()];
+}
+
+size_t TextView::GetFirstVisibleLine() const
+{
+	return static_cast<size_t>(m_firstVisible - GetOldestLine());
+}
+
+void TextView::Draw(const std::shared_ptr<Renderer>& renderer)
+{
+	if (!m_font || m_slots.empty())
+	{
+		return;
+	}
+
+	PROFILE_SCOPE("TextView::Draw");
+
+	uint64_t end = std::min(m_firstVisible + m_visibleLineCount, m_appendedCount);
+	for (uint64_t line = m_firstVisible; line < end; line++)
+	{
+		// a line given its slot after the dirty texts were updated shows from the next frame
+		LineSlot& slot = m_slots[line % m_slots.size()];
+		if (slot.line != line || slot.text->IsDirty() || slot.text->GetText().empty())
+		{
+			continue;
+		}
+
+		// texts are centered on their position, lines are aligned on the left
+		glm::vec3 size = slot.text->GetScale();
+		glm::vec3 position(m_x + size.x / 2.f, m_y + static_cast<float>(line - m_firstVisible) * m_lineSkip + size.y / 2.f, 0.f);
+		if (slot.text->GetPosition() != position)
+		{
+			slot.text->SetPosition(position);
+			slot.text->ResetInterpolation();
+		}
+		renderer->AddObject(slot.text);
+	}
+}
+
+uint64_t TextView::GetOldestLine() const
+{
+	return m_appendedCount - m_lines.size();
+}
+
+void TextView::AssignSlots()
+{
+	if (m_slots.empty())
+	{
+		return;
+	}
+
+	// a line keeps its slot while it is visible, only the lines scrolled into view are rebuilt
+	uint64_t oldest = GetOldestLine();
+	uint64_t end = std::min(m_firstVisible + m_visibleLineCount, m_appendedCount);
+	for (uint64_t line = m_firstVisible; line < end; line++)
+	{
+		LineSlot& slot = m_slots[line % m_slots.size()];
+		if (slot.line != line)
+		{
+			slot.line = line;
+			slot.text->SetText(GetLine(static_cast<size_t>(line - oldest)));
+		}
+	}
+}
+
+void TextView::ClampScroll()
+{
+	uint64_t oldest = GetOldestLine();
+	uint64_t bottom = m_appendedCount > oldest + m_visibleLineCount ? m_appendedCount - m_visibleLineCount : oldest;
+	m_firstVisible = std::min(std::max(m_firstVisible, oldest), bottom);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL2/SDL_ttf.h>
+
+class Renderer;
+class Text;
+
+/**
+ * @class TextView
+ * @brief A scrolling block of text lines, such as a console or a chat log.
+ *
+ * The lines are kept in a ring buffer, the oldest line is dropped once it is full. Only the
+ * lines inside the viewport are laid out, each by one of a fixed pool of Text objects, so a
+ * log of a hundred thousand lines costs the same to draw as one of forty. A pooled text keeps
+ * its line while it stays visible: scrolling or appending rebuilds the lines that came into
+ * view only, laid out with the other changed texts by Text::UpdateDirtyTexts before the frame
+ * is drawn. Lines are not wrapped, '\n' starts a new line.
+ */
+class TextView
+{
+public:
+	/**
+	 * @brief Constructs an empty view.
+	 * @param fontPath The font file in the font folder.
+	 * @param fontSize The size of the font.
+	 * @param capacity The number of lines kept, the oldest are dropped beyond it.
+	 * @param visibleLineCount The number of lines in the viewport.
+	 * @param color The color of the text. Defaults to black (0, 0, 0, 255).
+	 */
+	TextView(const std::string& fontPath, int fontSize, size_t capacity, int visibleLineCount, const SDL_Color& color = { 0, 0, 0, 255 });
+
+	/**
+	 * @brief Destructor.
+	 */
+	~TextView();
+
+	/**
+	 * @brief Appends text at the end of the log.
+	 * @param text The text, split into several lines at '\n'.
+	 *
+	 * A view scrolled to the bottom stays at the bottom.
+	 */
+	void AppendLine(const std::string& text);
+
+	/**
+	 * @brief Removes every line.
+	 */
+	void Clear();
+
+	/**
+	 * @brief Scrolls the view.
+	 * @param lineCount Number of lines to scroll, positive toward the newest lines.
+	 */
+	void Scroll(int lineCount);
+
+	/**
+	 * @brief Scrolls to the newest lines and follows the lines appended next.
+	 */
+	void ScrollToBottom();
+
+	/**
+	 * @brief Sets the top left corner of the viewport.
+	 * @param x The x-coordinate of the corner.
+	 * @param y The y-coordinate of the corner.
+	 */
+	void SetPosition(float x, float y);
+
+	/**
+	 * @brief Sets the number of lines in the viewport.
+	 * @param visibleLineCount The number of lines.
+	 */
+	void SetVisibleLineCount(int visibleLineCount);
+
+	/**
+	 * @brief Gets the number of lines kept.
+	 * @return The line count, at most the capacity.
+	 */
+	size_t GetLineCount() const;
+
+	/**
+	 * @brief Gets a line.
+	 * @param index The line index, 0 for the oldest line kept.
+	 * @return The line, empty if no line is kept.
+	 */
+	const std::string& GetLine(size_t index) const;
+
+	/**
+	 * @brief Gets the index of the line at the top of the viewport.
+	 * @return The line index, 0 for the oldest line kept.
+	 */
+	size_t GetFirstVisibleLine() const;
+
+	/**
+	 * @brief Places the visible lines and adds them to a renderer. Call it in the Draw() method of the state.
+	 * @param renderer The renderer, a SpriteRenderer.
+	 */
+	void Draw(const std::shared_ptr<Renderer>& renderer);
+
+private:
+	/**
+	 * @brief A pooled text and the line it shows.
+	 */
+	struct LineSlot
+	{
+		std::shared_ptr<Text> text;		///< The text.
+		uint64_t line;					///< Sequence number of the line shown, UINT64_MAX for none.
+	};
+
+	/**
+	 * @brief Gets the sequence number of the oldest line kept.
+	 * @return The sequence number, lines are numbered from 0 in the order they were appended.
+	 */
+	uint64_t GetOldestLine() const;
+
+	/**
+	 * @brief Keeps the first visible line inside the lines kept.
+	 */
+	void ClampScroll();
+
+	/**
+	 * @brief Gives the lines that came into view to their slot, the texts are laid out with the other dirty texts.
+	 */
+	void AssignSlots();
+
+	std::shared_ptr<TTF_Font> m_font;		///< The shared font of the lines.
+	int m_fontSize;							///< The size of the font.
+	int m_lineSkip;							///< Distance between two lines in pixels.
+	SDL_Color m_color;						///< The color of the text.
+	std::vector<std::string> m_lines;		///< The ring buffer of lines.
+	size_t m_capacity;						///< The maximum number of lines kept.
+	size_t m_start;							///< Index of the oldest line in the ring buffer.
+	uint64_t m_appendedCount;				///< Number of lines appended since the view was cleared.
+	uint64_t m_firstVisible;				///< Sequence number of the line at the top of the viewport.
+	bool m_followTail;						///< True to stay at the bottom when lines are appended.
+	int m_visibleLineCount;					///< Number of lines in the viewport.
+	float m_x;								///< Left of the viewport.
+	float m_y;								///< Top of the viewport.
+	std::vector<LineSlot> m_slots;			///< The pooled texts, line n is shown by slot n % slot count.
+};
\ No newline at end of file
@@ -1,15 +1,57 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "Texture.h"
 
-Texture::Texture(const std::string& filePath) 
+#include <algorithm>
+#include <vector>
+
+#include "Game.h"
+#include "MipChain.h"
+#include "TextureCache.h"
+
+uint64_t Texture::s_frame = 0;
+
+// bound in place of textures that are still loading
+static GLuint s_placeholderID = 0;
+
+static GLuint GetPlaceholderID()
+{
+    if (s_placeholderID == 0)
+    {
+        const unsigned char transparent[4] = { 0, 0, 0, 0 };
+        glGenTextures(1, &s_placeholderID);
+        glBindTexture(GL_TEXTURE_2D, s_placeholderID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+    }
+    return s_placeholderID;
+}
+
+Texture::Texture(const std::string& filePath, TextureFilterMode mode) 
 {
     m_iTextureID = 0;
+    m_width = 0;
+    m_height = 0;
+    m_ready = false;
+    m_filterMode = mode;
+    m_levelCount = 0;
+    // a texture not bound yet counts as used now, so a preloaded one is not evicted first
+    m_lastBindFrame = s_frame;
+    m_uvRect = glm::vec4(0.f, 0.f, 1.f, 1.f);
     LoadImage(filePath);
 }
 
 Texture::Texture()
 {
-
+    m_iTextureID = 0;
+    m_width = 0;
+    m_height = 0;
+    m_ready = true;
+    m_filterMode = TextureFilterMode::NEAREST;
+    m_levelCount = 0;
+    // a texture not bound yet counts as used now, so a preloaded one is not evicted first
+    m_lastBindFrame = s_frame;
+    m_uvRect = glm::vec4(0.f, 0.f, 1.f, 1.f);
 }
 
 Texture::~Texture()
@@ -19,69 +61,249 @@ Texture::~Texture()
 
 void Texture::Bind(GLuint textureUnit) 
 {
+    if (m_atlasPage)
+    {
+        m_atlasPage->Bind(textureUnit);
+        return;
+    }
+    m_lastBindFrame = s_frame;
     glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, m_iTextureID);
+    glBindTexture(GL_TEXTURE_2D, m_ready ? m_iTextureID : GetPlaceholderID());
 }
 
 void Texture::SetFilter(TextureFilterMode mode)
 {
+    if (m_atlasPage)
+    {
+        m_atlasPage->SetFilter(mode);
+        return;
+    }
+
+    m_filterMode = mode;
+    if (m_iTextureID == 0 || !m_ready)
+    {
+        // applied once the upload is done
+        return;
+    }
+
     glBindTexture(GL_TEXTURE_2D, m_iTextureID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    if (m_filterMode == TextureFilterMode::MIPMAP && m_levelCount < MipChain::GetLevelCount(m_width, m_height))
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        m_levelCount = MipChain::GetLevelCount(m_width, m_height);
+    }
+    ApplyFilter();
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Texture::SetFilter(GLint mode)
 {
-    glBindTexture(GL_TEXTURE_2D, m_iTextureID);
     if (mode == 0)
     {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        SetFilter(TextureFilterMode::NEAREST);
     }
     else if (mode == 1)
     {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        SetFilter(TextureFilterMode::LINEAR);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+TextureFilterMode Texture::GetFilter() const
+{
+    return m_atlasPage ? m_atlasPage->GetFilter() : m_filterMode;
 }
 
 GLuint Texture::GetTextureID() const
 {
-    return m_iTextureID;
+    return m_atlasPage ? m_atlasPage->GetTextureID() : m_iTextureID;
+}
+
+bool Texture::IsReady() const
+{
+    return m_ready;
+}
+
+int Texture::GetWidth() const
+{
+    return m_width;
+}
+
+int Texture::GetHeight() const
+{
+    return m_height;
+}
+
+size_t Texture::GetMemorySize() const
+{
+    if (m_atlasPage || m_iTextureID == 0)
+    {
+        return 0;
+    }
+
+    size_t size = 0;
+    int width = m_width, height = m_height;
+    for (int level = 0; level < std::max(m_levelCount, 1); level++)
+    {
+        size += static_cast<size_t>(width) * height * 4;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return size;
+}
+
+const glm::vec4& Texture::GetUVRect() const
+{
+    return m_uvRect;
+}
+
+std::shared_ptr<Texture> Texture::GetAtlasPage() const
+{
+    return m_atlasPage;
+}
+
+void Texture::DeletePlaceholder()
+{
+    if (s_placeholderID != 0)
+    {
+        glDeleteTextures(1, &s_placeholderID);
+        s_placeholderID = 0;
+    }
+}
+
+void Texture::CreateStorage(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_ready = false;
+    m_levelCount = 1;
+
+    glGenTextures(1, &m_iTextureID);
+    glBindTexture(GL_TEXTURE_2D, m_iTextureID);
+
+    // same parameters as a synchronous load, the mip levels come with FinishUpload
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_filterMode == TextureFilterMode::LINEAR ? GL_LINEAR : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_filterMode == TextureFilterMode::NEAREST ? GL_NEAREST : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::UploadRows(int firstRow, int rowCount, const void* pixels)
+{
+    glBindTexture(GL_TEXTURE_2D, m_iTextureID);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, m_width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::FinishUpload(const std::vector<MipLevel>& mips)
+{
+    glBindTexture(GL_TEXTURE_2D, m_iTextureID);
+    m_levelCount = 1;
+    if (m_filterMode == TextureFilterMode::MIPMAP)
+    {
+        for (const auto& mip : mips)
+        {
+            glTexImage2D(GL_TEXTURE_2D, m_levelCount++, GL_RGBA, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, mip.pixels.data());
+        }
+        if (m_levelCount < MipChain::GetLevelCount(m_width, m_height))
+        {
+            // the chain was not built, let the driver do it
+            glGenerateMipmap(GL_TEXTURE_2D);
+            m_levelCount = MipChain::GetLevelCount(m_width, m_height);
+        }
+    }
+    ApplyFilter();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_ready = true;
+
+    // loaded or reloaded in the background, the budget counts it as used from now
+    m_lastBindFrame = s_frame;
+}
+
+void Texture::ApplyFilter()
+{
+    bool mipmapped = m_filterMode == TextureFilterMode::MIPMAP && m_levelCount > 1;
+    GLint minFilter = mipmapped ? GL_LINEAR_MIPMAP_LINEAR : (m_filterMode == TextureFilterMode::NEAREST ? GL_NEAREST : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_filterMode == TextureFilterMode::NEAREST ? GL_NEAREST : GL_LINEAR);
+
+    // levels past the last one uploaded would make the texture incomplete
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(m_levelCount - 1, 0));
+}
+
+void Texture::Evict()
+{
+    glDeleteTextures(1, &m_iTextureID);
+    m_iTextureID = 0;
+    m_levelCount = 0;
+    m_ready = false;
 }
 
 void Texture::LoadImage(const std::string& filePath) 
 {
+    // a cached entry skips decoding, and holds the mip chain for textures that use it
+    bool mipmapped = m_filterMode == TextureFilterMode::MIPMAP;
+    bool cached = TextureCache::Read(filePath, [this](int level, int width, int height, const unsigned char* pixels)
+        {
+            if (level == 0)
+            {
+                glGenTextures(1, &m_iTextureID);
+                glBindTexture(GL_TEXTURE_2D, m_iTextureID);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+                m_width = width;
+                m_height = height;
+            }
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+            m_levelCount = level + 1;
+        }, mipmapped ? 32 : 1);
+
+    if (cached)
+    {
+        ApplyFilter();
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_ready = true;
+        return;
+    }
+    if (m_iTextureID != 0)
+    {
+        // the entry was corrupted after the first level
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDeleteTextures(1, &m_iTextureID);
+        m_iTextureID = 0;
+    }
+
+    // always RGBA, rows of odd width RGB images would need a different unpack alignment
     int width, height, nrChannels;
-    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
 
     if (data) 
     {
-        GLenum format;
-        format = GL_RGBA;
-        if (nrChannels == 1)
-        {
-            format = GL_RED;
-        }
-        else 
-        if (nrChannels == 3)
+        // the caller waits for this texture anyway, the chain of other textures is built by the cache job
+        auto mips = std::make_shared<std::vector<MipLevel>>();
+        if (mipmapped)
         {
-            format = GL_RGB;
+            MipChain::Build(data, width, height, *mips);
         }
+
         glGenTextures(1, &m_iTextureID);
         glBindTexture(GL_TEXTURE_2D, m_iTextureID);
 
         // Set texture parameters 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
         // Load image data into the texture
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        m_levelCount = 1;
+        for (const auto& mip : *mips)
+        {
+            glTexImage2D(GL_TEXTURE_2D, m_levelCount++, GL_RGBA, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, mip.pixels.data());
+        }
+        ApplyFilter();
 
         GLenum error = glGetError();
         if (error != GL_NO_ERROR)
@@ -91,6 +313,24 @@ void Texture::LoadImage(const std::string& filePath)
 
         // Unbind texture
         glBindTexture(GL_TEXTURE_2D, 0);
+
+        m_width = width;
+        m_height = height;
+        m_ready = true;
+
+        // the cache is written on a worker so the first launch does not wait for it
+        if (TextureCache::IsEnabled())
+        {
+            auto pixels = std::make_shared<std::vector<unsigned char>>(data, data + static_cast<size_t>(width) * height * 4);
+            JOBS()->Run([filePath, pixels, mips, width, height]()
+                {
+                    if (mips->empty())
+                    {
+                        MipChain::Build(pixels->data(), width, height, *mips);
+                    }
+                    TextureCache::Write(filePath, pixels->data(), width, height, *mips);
+                });
+        }
     }
     else 
     {
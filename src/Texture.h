@@ -1,19 +1,25 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include <iostream>
 #include "stb_image.h"
 
+struct MipLevel;
+
 /**
  * @enum TextureFilterMode
  * @brief Specifies the texture filtering mode.
  */
 enum class TextureFilterMode 
 {
-	NEAREST,		///< Nearest-neighbor filtering.
-	LINEAR,			///< Linear filtering.
-	MIPMAP			///< Mipmap filtering. Currently unused.
+	NEAREST,		///< Nearest-neighbor filtering without mip levels, for pixel art.
+	LINEAR,			///< Linear filtering without mip levels.
+	MIPMAP			///< Trilinear filtering through a mip chain, for scaled down textures.
 };
 
 /**
@@ -28,11 +34,12 @@ public:
 	/**
 	 * @brief Constructs a Texture object and loads an image from a file.
 	 * @param filePath The path to the image file.
+	 * @param mode The filtering mode. Only MIPMAP uploads the mip levels.
 	 */
-	Texture(const std::string& filePath);
+	Texture(const std::string& filePath, TextureFilterMode mode = TextureFilterMode::NEAREST);
 
 	/**
-	 * @brief Default constructor for Texture.
+	 * @brief Default constructor for Texture. The texture ID is filled by the owner (see Text).
 	 */
 	Texture();
 
@@ -44,15 +51,28 @@ public:
 	/**
 	 * @brief Binds the texture to a specified texture unit.
 	 * @param textureUnit The texture unit to bind to (default is 0).
+	 *
+	 * A texture still loading in the background binds a 1x1 transparent placeholder instead.
+	 * An atlas image binds its atlas page. Binding records the frame for the texture budget
+	 * of the ResourceManager, which reloads an evicted texture once it is bound again.
 	 */
 	void Bind(GLuint textureUnit = 0);
 
 	/**
 	 * @brief Sets the texture filtering mode.
 	 * @param mode The filtering mode to set.
+	 *
+	 * Switching a texture loaded without mip levels to MIPMAP generates them on the GPU.
+	 * Pass the mode on load instead to get the mip chain of the texture cache.
 	 */
 	void SetFilter(TextureFilterMode mode);
 
+	/**
+	 * @brief Gets the texture filtering mode.
+	 * @return The filtering mode.
+	 */
+	TextureFilterMode GetFilter() const;
+
 	/**
 	 * @brief Sets the texture filtering mode using an integer.
 	 * @param mode The filtering mode to set (0 for NEAREST, 1 for LINEAR).
@@ -61,13 +81,96 @@ public:
 
 	/**
 	 * @brief Gets the ID of the texture.
-	 * @return The texture ID.
+	 * @return The texture ID, the ID of the atlas page for an atlas image.
 	 */
 	GLuint GetTextureID() const;
+
+	/**
+	 * @brief Checks if the pixels are on the GPU.
+	 * @return False while an asynchronous load is in progress or if the load failed.
+	 */
+	bool IsReady() const;
+
+	/**
+	 * @brief Gets the width of the image.
+	 * @return The width in pixels, 0 until the size is known.
+	 */
+	int GetWidth() const;
+
+	/**
+	 * @brief Gets the height of the image.
+	 * @return The height in pixels, 0 until the size is known.
+	 */
+	int GetHeight() const;
+
+	/**
+	 * @brief Gets the GPU memory used by the texture.
+	 * @return The bytes of all its mip levels, 0 for an atlas image or an evicted texture.
+	 */
+	size_t GetMemorySize() const;
+
+	/**
+	 * @brief Gets the part of the bound texture covered by this image.
+	 * @return The rect as (u0, v0, u1, v1), (0, 0, 1, 1) unless the image lives in an atlas.
+	 */
+	const glm::vec4& GetUVRect() const;
+
+	/**
+	 * @brief Gets the atlas page holding this image.
+	 * @return The page, or nullptr if the texture is not part of an atlas.
+	 */
+	std::shared_ptr<Texture> GetAtlasPage() const;
+
+	/**
+	 * @brief Deletes the shared placeholder texture. Called when all resources are freed.
+	 */
+	static void DeletePlaceholder();
 	
-	friend class Text;		///< Grants the Text class access to Texture's private members.
+	friend class Text;				///< Grants the Text class access to Texture's private members.
+	friend class ResourceManager;	///< Grants the ResourceManager access to the streaming upload.
+	friend class TextureAtlas;		///< Grants the TextureAtlas access to the page storage and image rects.
 private:
-	GLuint m_iTextureID;	///< The ID of the texture.
+	GLuint m_iTextureID;					///< The ID of the texture.
+	int m_width;							///< Width of the image in pixels.
+	int m_height;							///< Height of the image in pixels.
+	bool m_ready;							///< True once the pixels are uploaded.
+	TextureFilterMode m_filterMode;			///< Filtering mode.
+	int m_levelCount;						///< Number of mip levels on the GPU.
+	uint64_t m_lastBindFrame;				///< Frame of the last Bind.
+	static uint64_t s_frame;				///< Current frame, advanced by the ResourceManager.
+	glm::vec4 m_uvRect;						///< Part of the bound texture covered by the image.
+	std::shared_ptr<Texture> m_atlasPage;	///< Atlas page holding the image, nullptr for a standalone texture.
+
+	/**
+	 * @brief Creates an empty RGBA texture to be filled with UploadRows.
+	 * @param width The width in pixels.
+	 * @param height The height in pixels.
+	 */
+	void CreateStorage(int width, int height);
+
+	/**
+	 * @brief Uploads a band of rows of RGBA pixels.
+	 * @param firstRow Index of the first row.
+	 * @param rowCount Number of rows.
+	 * @param pixels The pixels, or an offset in the bound pixel unpack buffer.
+	 */
+	void UploadRows(int firstRow, int rowCount, const void* pixels);
+
+	/**
+	 * @brief Uploads the mip levels if the texture uses them and marks the texture as ready.
+	 * @param mips The levels below the image, see MipChain::Build.
+	 */
+	void FinishUpload(const std::vector<MipLevel>& mips);
+
+	/**
+	 * @brief Applies the filtering mode to the bound texture.
+	 */
+	void ApplyFilter();
+
+	/**
+	 * @brief Frees the GPU storage. The texture binds the placeholder until it is uploaded again.
+	 */
+	void Evict();
 
 	/**
 	 * @brief Loads an image from a file and creates an OpenGL texture.
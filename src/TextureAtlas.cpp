@@ -0,0 +1,349 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Texture.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+// imgui links its own copy of the packer, keep this one private to the file
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+unsigned int TextureAtlas::s_layoutVersion = 0;
+
+/**
+ * @brief A page texture and the packer state of its free space.
+ */
+struct TextureAtlas::Page
+{
+	std::shared_ptr<Texture> texture;	///< The page texture, shared with the images on it.
+	int width;							///< Width of the page in pixels.
+	int height;							///< Height of the page in pixels.
+	stbrp_context context;				///< Packer state. Points into nodes, the page must not be copied.
+	std::vector<stbrp_node> nodes;		///< Packer nodes, one per column.
+	bool needUpload;					///< True when the texture has to be created again.
+
+	Page(int pageWidth, int pageHeight) : width(pageWidth), height(pageHeight), nodes(pageWidth), needUpload(true)
+	{
+		stbrp_init_target(&context, width, height, nodes.data(), static_cast<int>(nodes.size()));
+	}
+};
+
+TextureAtlas::TextureAtlas(int pageSize, int maxPageSize, int padding) :
+	m_pageSize(pageSize), m_maxPageSize(std::max(pageSize, maxPageSize)), m_padding(padding)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+std::shared_ptr<Texture> TextureAtlas::Add(const std::string& name, const std::string& filePath)
+{
+	auto it = m_entries.find(name);
+	if (it != m_entries.end())
+	{
+		return it->second.image;
+	}
+
+	int width, height, channels;
+	unsigned char* pixels = stbi_load(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+	if (!pixels)
+	{
+		LogError("Failed to load atlas image: %s", filePath.c_str());
+		return nullptr;
+	}
+
+	std::shared_ptr<Texture> image = Add(name, pixels, width, height);
+	stbi_image_free(pixels);
+	return image;
+}
+
+std::shared_ptr<Texture> TextureAtlas::Add(const std::string& name, const unsigned char* pixels, int width, int height)
+{
+	PROFILE_SCOPE("TextureAtlas::Add");
+
+	auto it = m_entries.find(name);
+	if (it != m_entries.end())
+	{
+		return it->second.image;
+	}
+
+	int paddedWidth = width + m_padding * 2;
+	int paddedHeight = height + m_padding * 2;
+	if (paddedWidth > m_maxPageSize || paddedHeight > m_maxPageSize)
+	{
+		LogWarning("%s (%dx%d) is too large for a %d atlas page", name.c_str(), width, height, m_maxPageSize);
+		return nullptr;
+	}
+
+	Entry entry;
+	entry.image = std::make_shared<Texture>();
+	entry.image->m_width = width;
+	entry.image->m_height = height;
+	entry.width = paddedWidth;
+	entry.height = paddedHeight;
+	entry.page = -1;
+	entry.x = 0;
+	entry.y = 0;
+
+	// copy the image and repeat its border pixels in the padding
+	entry.pixels.resize(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+	for (int y = 0; y < paddedHeight; y++)
+	{
+		int sourceY = std::min(std::max(y - m_padding, 0), height - 1);
+		for (int x = 0; x < paddedWidth; x++)
+		{
+			int sourceX = std::min(std::max(x - m_padding, 0), width - 1);
+			std::memcpy(&entry.pixels[(static_cast<size_t>(y) * paddedWidth + x) * 4],
+				&pixels[(static_cast<size_t>(sourceY) * width + sourceX) * 4], 4);
+		}
+	}
+
+	Entry& placed = m_entries[name] = std::move(entry);
+	if (!Place(placed))
+	{
+		m_entries.erase(name);
+		return nullptr;
+	}
+
+	Page& page = *m_pages[placed.page];
+	if (page.needUpload)
+	{
+		// new or grown page, every image on it is sent again
+		UploadPage(placed.page);
+	}
+	else
+	{
+		UploadEntry(placed);
+		UpdateImage(placed);
+	}
+	return placed.image;
+}
+
+std::shared_ptr<Texture> TextureAtlas::Get(const std::string& name) const
+{
+	auto it = m_entries.find(name);
+	return it != m_entries.end() ? it->second.image : nullptr;
+}
+
+void TextureAtlas::Remove(const std::string& name)
+{
+	auto it = m_entries.find(name);
+	if (it == m_entries.end())
+	{
+		return;
+	}
+
+	// leftover users bind the transparent placeholder
+	it->second.image->m_atlasPage = nullptr;
+	it->second.image->m_ready = false;
+	m_entries.erase(it);
+}
+
+void TextureAtlas::Repack()
+{
+	PROFILE_SCOPE("TextureAtlas::Repack");
+
+	std::vector<Entry*> entries;
+	entries.reserve(m_entries.size());
+	for (auto& it : m_entries)
+	{
+		it.second.page = -1;
+		entries.push_back(&it.second);
+	}
+
+	// tallest first packs the skyline tighter
+	std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b)
+		{
+			return a->height != b->height ? a->height > b->height : a->width > b->width;
+		});
+
+	m_pages.clear();
+	for (Entry* entry : entries)
+	{
+		Place(*entry);
+	}
+	for (size_t i = 0; i < m_pages.size(); i++)
+	{
+		UploadPage(static_cast<int>(i));
+	}
+	s_layoutVersion++;
+
+	LogInfo("Texture atlas repacked: %zu images on %zu pages", m_entries.size(), m_pages.size());
+}
+
+void TextureAtlas::Clear()
+{
+	for (auto& it : m_entries)
+	{
+		it.second.image->m_atlasPage = nullptr;
+		it.second.image->m_ready = false;
+	}
+	m_entries.clear();
+	m_pages.clear();
+	s_layoutVersion++;
+}
+
+size_t TextureAtlas::GetPageCount() const
+{
+	return m_pages.size();
+}
+
+std::shared_ptr<Texture> TextureAtlas::GetPage(size_t index) const
+{
+	return index < m_pages.size() ? m_pages[index]->texture : nullptr;
+}
+
+size_t TextureAtlas::GetImageCount() const
+{
+	return m_entries.size();
+}
+
+unsigned int TextureAtlas::GetLayoutVersion()
+{
+	return s_layoutVersion;
+}
+
+bool TextureAtlas::Place(Entry& entry)
+{
+	stbrp_rect rect = {};
+	rect.w = entry.width;
+	rect.h = entry.height;
+
+	// fill the free space left on the pages first
+	for (size_t i = 0; i < m_pages.size(); i++)
+	{
+		if (stbrp_pack_rects(&m_pages[i]->context, &rect, 1))
+		{
+			entry.page = static_cast<int>(i);
+			entry.x = rect.x;
+			entry.y = rect.y;
+			return true;
+		}
+	}
+
+	// earlier pages are already at the maximum size
+	if (!m_pages.empty() && GrowPage(static_cast<int>(m_pages.size()) - 1, entry))
+	{
+		return true;
+	}
+
+	int size = m_pageSize;
+	while (size < entry.width || size < entry.height)
+	{
+		size = std::min(size * 2, m_maxPageSize);
+	}
+
+	std::unique_ptr<Page> page = std::make_unique<Page>(size, size);
+	page->texture = std::make_shared<Texture>();
+	if (!stbrp_pack_rects(&page->context, &rect, 1))
+	{
+		return false;
+	}
+
+	entry.page = static_cast<int>(m_pages.size());
+	entry.x = rect.x;
+	entry.y = rect.y;
+	m_pages.push_back(std::move(page));
+	return true;
+}
+
+bool TextureAtlas::GrowPage(int pageIndex, Entry& extra)
+{
+	std::vector<Entry*> entries;
+	for (auto& it : m_entries)
+	{
+		if (it.second.page == pageIndex)
+		{
+			entries.push_back(&it.second);
+		}
+	}
+	entries.push_back(&extra);
+
+	std::vector<stbrp_rect> rects(entries.size());
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		rects[i] = {};
+		rects[i].id = static_cast<int>(i);
+		rects[i].w = entries[i]->width;
+		rects[i].h = entries[i]->height;
+	}
+
+	int size = m_pages[pageIndex]->width;
+	while (size < m_maxPageSize)
+	{
+		size = std::min(size * 2, m_maxPageSize);
+
+		// a fresh packer at the larger size, the current page stays valid if this fails
+		std::unique_ptr<Page> grown = std::make_unique<Page>(size, size);
+		if (!stbrp_pack_rects(&grown->context, rects.data(), static_cast<int>(rects.size())))
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			entries[i]->page = pageIndex;
+			entries[i]->x = rects[i].x;
+			entries[i]->y = rects[i].y;
+		}
+
+		// images keep pointing at the same page texture
+		grown->texture = m_pages[pageIndex]->texture;
+		m_pages[pageIndex] = std::move(grown);
+		s_layoutVersion++;
+		return true;
+	}
+	return false;
+}
+
+void TextureAtlas::UploadPage(int pageIndex)
+{
+	PROFILE_SCOPE("TextureAtlas::UploadPage");
+
+	Page& page = *m_pages[pageIndex];
+	Texture& texture = *page.texture;
+	if (texture.m_iTextureID)
+	{
+		glDeleteTextures(1, &texture.m_iTextureID);
+		texture.m_iTextureID = 0;
+	}
+
+	// no mipmaps, they would blend neighbouring images
+	texture.CreateStorage(page.width, page.height);
+	texture.m_ready = true;
+
+	for (auto& it : m_entries)
+	{
+		if (it.second.page == pageIndex)
+		{
+			UploadEntry(it.second);
+			UpdateImage(it.second);
+		}
+	}
+	page.needUpload = false;
+}
+
+void TextureAtlas::UploadEntry(const Entry& entry)
+{
+	glBindTexture(GL_TEXTURE_2D, m_pages[entry.page]->texture->m_iTextureID);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, entry.x, entry.y, entry.width, entry.height, GL_RGBA, GL_UNSIGNED_BYTE, entry.pixels.data());
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TextureAtlas::UpdateImage(Entry& entry)
+{
+	const Page& page = *m_pages[entry.page];
+	Texture& image = *entry.image;
+
+	float left = static_cast<float>(entry.x + m_padding);
+	float top = static_cast<float>(entry.y + m_padding);
+	image.m_uvRect = glm::vec4(left / page.width, top / page.height,
+		(left + image.m_width) / page.width, (top + image.m_height) / page.height);
+	image.m_atlasPage = page.texture;
+	image.m_ready = true;
+}
\ No newline at end of file
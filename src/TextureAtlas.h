@@ -0,0 +1,163 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Texture;
+
+/**
+ * @class TextureAtlas
+ * @brief Packs many small images into a few shared textures.
+ *
+ * Every added image is handed out as a Texture that binds its atlas page and carries the
+ * UV rect of the image inside it, so sprites and batches use it like any other texture and
+ * images on the same page are drawn together. When a page is full it is grown and repacked
+ * up to the maximum page size, then a new page is opened.
+ */
+class TextureAtlas
+{
+public:
+	/**
+	 * @brief Constructs an empty atlas.
+	 * @param pageSize Size of a new page in pixels.
+	 * @param maxPageSize Size a page can grow to in pixels.
+	 * @param padding Pixels around each image, filled with its border pixels to avoid bleeding.
+	 */
+	TextureAtlas(int pageSize = 512, int maxPageSize = 4096, int padding = 2);
+
+	/**
+	 * @brief Destructor. Images handed out keep their page alive.
+	 */
+	~TextureAtlas();
+
+	/**
+	 * @brief Loads an image from a file and adds it to the atlas.
+	 * @param name The name of the image.
+	 * @param filePath The path to the image file.
+	 * @return The image, or nullptr if it can not be loaded or is larger than a page.
+	 */
+	std::shared_ptr<Texture> Add(const std::string& name, const std::string& filePath);
+
+	/**
+	 * @brief Adds RGBA pixels to the atlas.
+	 * @param name The name of the image. Adding a name twice returns the existing image.
+	 * @param pixels The pixels, 4 bytes each, top row first.
+	 * @param width The width in pixels.
+	 * @param height The height in pixels.
+	 * @return The image, or nullptr if it is larger than a page.
+	 */
+	std::shared_ptr<Texture> Add(const std::string& name, const unsigned char* pixels, int width, int height);
+
+	/**
+	 * @brief Retrieves an image.
+	 * @param name The name of the image.
+	 * @return The image, or nullptr if it is not in the atlas.
+	 */
+	std::shared_ptr<Texture> Get(const std::string& name) const;
+
+	/**
+	 * @brief Removes an image. Its space is reclaimed on the next Repack.
+	 * @param name The name of the image.
+	 *
+	 * Sprites still using the image draw nothing.
+	 */
+	void Remove(const std::string& name);
+
+	/**
+	 * @brief Packs all images again, tallest first, into as few pages as possible.
+	 *
+	 * Worth calling after many images were removed or at the end of a loading screen.
+	 */
+	void Repack();
+
+	/**
+	 * @brief Removes all images and deletes the pages.
+	 */
+	void Clear();
+
+	/**
+	 * @brief Gets the number of pages.
+	 * @return The page count.
+	 */
+	size_t GetPageCount() const;
+
+	/**
+	 * @brief Gets a page texture, useful to inspect the atlas.
+	 * @param index The index of the page.
+	 * @return The page texture.
+	 */
+	std::shared_ptr<Texture> GetPage(size_t index) const;
+
+	/**
+	 * @brief Gets the number of images in the atlas.
+	 * @return The image count.
+	 */
+	size_t GetImageCount() const;
+
+	/**
+	 * @brief Gets a counter increased every time an atlas moves images that are already placed.
+	 * @return The layout version, shared by all atlases.
+	 *
+	 * Renderers that bake UVs check it to know when to rebuild.
+	 */
+	static unsigned int GetLayoutVersion();
+
+private:
+	/**
+	 * @brief An image placed in the atlas.
+	 */
+	struct Entry
+	{
+		std::shared_ptr<Texture> image;		///< The texture handed out for the image.
+		std::vector<unsigned char> pixels;	///< RGBA pixels including the padding.
+		int width;							///< Width including the padding.
+		int height;							///< Height including the padding.
+		int page;							///< Index of the page, -1 when not placed.
+		int x;								///< Left of the padded image in the page.
+		int y;								///< Top of the padded image in the page.
+	};
+
+	struct Page;
+
+	/**
+	 * @brief Places an image on a page, growing the last page or opening a new one if needed.
+	 * @param entry The image.
+	 * @return True if the image was placed.
+	 */
+	bool Place(Entry& entry);
+
+	/**
+	 * @brief Repacks a page with an extra image at twice its size, until it fits or reaches the maximum.
+	 * @param pageIndex The index of the page.
+	 * @param extra The image to add.
+	 * @return True if the page was grown.
+	 */
+	bool GrowPage(int pageIndex, Entry& extra);
+
+	/**
+	 * @brief Creates the page texture at the page size and uploads all its images.
+	 * @param pageIndex The index of the page.
+	 */
+	void UploadPage(int pageIndex);
+
+	/**
+	 * @brief Uploads one image to its page.
+	 * @param entry The image.
+	 */
+	void UploadEntry(const Entry& entry);
+
+	/**
+	 * @brief Points the image texture at its page and rect.
+	 * @param entry The image.
+	 */
+	void UpdateImage(Entry& entry);
+
+	int m_pageSize;										///< Size of a new page.
+	int m_maxPageSize;									///< Size a page can grow to.
+	int m_padding;										///< Pixels around each image.
+	std::unordered_map<std::string, Entry> m_entries;	///< The images by name.
+	std::vector<std::unique_ptr<Page>> m_pages;			///< The pages.
+	static unsigned int s_layoutVersion;				///< Increased when placed images move.
+};
\ No newline at end of file
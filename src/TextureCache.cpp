@@ -0,0 +1,270 @@
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+#include "Logger.h"
+#include "Lz4.h"
+#include "MappedFile.h"
+#include "MipChain.h"
+#include "Profiler.h"
+
+namespace fs = std::filesystem;
+
+static const char CACHE_MAGIC[4] = { 'G', 'S', 'T', 'X' };
+static const uint32_t CACHE_VERSION = 2;
+static const uint32_t COMPRESSION_NONE = 0;
+static const uint32_t COMPRESSION_LZ4 = 1;
+static const int MAX_LEVELS = 32;
+
+static std::atomic<bool> s_enabled(true);
+static std::atomic<bool> s_compress(true);
+
+/**
+ * @brief Start of a .gstex file, followed by the level table and the level data.
+ */
+struct CacheHeader
+{
+	char magic[4];			///< "GSTX".
+	uint32_t version;		///< Format version.
+	uint32_t width;			///< Width of level 0.
+	uint32_t height;		///< Height of level 0.
+	uint32_t levelCount;	///< Number of mip levels.
+	uint32_t compression;	///< Compression of the levels that were worth compressing.
+	uint64_t sourceSize;	///< Size of the source image when the entry was written.
+	int64_t sourceTime;		///< Modification time of the source image when the entry was written.
+};
+
+/**
+ * @brief A mip level in the level table.
+ */
+struct CacheLevel
+{
+	uint32_t width;			///< Width of the level.
+	uint32_t height;		///< Height of the level.
+	uint64_t offset;		///< Position of the data from the start of the file.
+	uint64_t size;			///< Size of the RGBA pixels.
+	uint64_t storedSize;	///< Size in the file, equal to size when stored raw.
+};
+
+static_assert(sizeof(CacheHeader) == 40, "CacheHeader is written as is");
+static_assert(sizeof(CacheLevel) == 32, "CacheLevel is written as is");
+
+static bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time)
+{
+	std::error_code error;
+	size = static_cast<uint64_t>(fs::file_size(sourcePath, error));
+	if (error)
+	{
+		return false;
+	}
+	time = static_cast<int64_t>(fs::last_write_time(sourcePath, error).time_since_epoch().count());
+	return !error;
+}
+
+bool TextureCache::Read(const std::string& sourcePath, const LevelCallback& onLevel, int maxLevels)
+{
+	if (!s_enabled)
+	{
+		return false;
+	}
+
+	PROFILE_SCOPE("TextureCache::Read");
+
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	if (!GetSourceStamp(sourcePath, sourceSize, sourceTime))
+	{
+		return false;
+	}
+
+	MappedFile file;
+	if (!file.Open(GetCachePath(sourcePath)) || file.GetSize() < sizeof(CacheHeader))
+	{
+		return false;
+	}
+
+	// stale or foreign entries are skipped, Write replaces them
+	CacheHeader header;
+	std::memcpy(&header, file.GetData(), sizeof(header));
+	if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION
+		|| header.sourceSize != sourceSize || header.sourceTime != sourceTime
+		|| header.levelCount == 0 || header.levelCount > MAX_LEVELS
+		|| file.GetSize() < sizeof(CacheHeader) + header.levelCount * sizeof(CacheLevel))
+	{
+		return false;
+	}
+
+	std::vector<CacheLevel> levels(header.levelCount);
+	std::memcpy(levels.data(), file.GetData() + sizeof(CacheHeader), levels.size() * sizeof(CacheLevel));
+	for (const auto& level : levels)
+	{
+		if (level.offset > file.GetSize() || level.storedSize > file.GetSize() - level.offset
+			|| level.size != static_cast<uint64_t>(level.width) * level.height * 4)
+		{
+			LogWarning("Corrupted texture cache entry for %s", sourcePath.c_str());
+			return false;
+		}
+	}
+
+	std::vector<unsigned char> scratch;
+	int levelCount = std::min(static_cast<int>(header.levelCount), std::max(maxLevels, 1));
+	for (int i = 0; i < levelCount; i++)
+	{
+		const CacheLevel& level = levels[i];
+		const unsigned char* data = file.GetData() + level.offset;
+		if (level.storedSize != level.size)
+		{
+			scratch.resize(static_cast<size_t>(level.size));
+			if (!Lz4::Decompress(data, static_cast<size_t>(level.storedSize), scratch.data(), scratch.size()))
+			{
+				LogWarning("Corrupted texture cache entry for %s", sourcePath.c_str());
+				return false;
+			}
+			data = scratch.data();
+		}
+		onLevel(i, static_cast<int>(level.width), static_cast<int>(level.height), data);
+	}
+	return true;
+}
+
+bool TextureCache::Write(const std::string& sourcePath, const unsigned char* pixels, int width, int height)
+{
+	if (!s_enabled || !pixels || width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	std::vector<MipLevel> mips;
+	MipChain::Build(pixels, width, height, mips);
+	return Write(sourcePath, pixels, width, height, mips);
+}
+
+bool TextureCache::Write(const std::string& sourcePath, const unsigned char* pixels, int width, int height, const std::vector<MipLevel>& mips)
+{
+	if (!s_enabled || !pixels || width <= 0 || height <= 0 || mips.size() >= MAX_LEVELS)
+	{
+		return false;
+	}
+
+	PROFILE_SCOPE("TextureCache::Write");
+
+	CacheHeader header;
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.width = static_cast<uint32_t>(width);
+	header.height = static_cast<uint32_t>(height);
+	header.compression = s_compress ? COMPRESSION_LZ4 : COMPRESSION_NONE;
+	if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceTime))
+	{
+		return false;
+	}
+
+	std::vector<CacheLevel> levels;
+	std::vector<const unsigned char*> levelPixels;
+	levels.push_back({ header.width, header.height, 0, static_cast<uint64_t>(width) * height * 4, 0 });
+	levelPixels.push_back(pixels);
+	for (const auto& mip : mips)
+	{
+		levels.push_back({ static_cast<uint32_t>(mip.width), static_cast<uint32_t>(mip.height), 0, mip.pixels.size(), 0 });
+		levelPixels.push_back(mip.pixels.data());
+	}
+	header.levelCount = static_cast<uint32_t>(levels.size());
+
+	// levels that do not shrink are stored raw
+	std::vector<std::vector<unsigned char>> stored(levels.size());
+	uint64_t offset = sizeof(CacheHeader) + levels.size() * sizeof(CacheLevel);
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		size_t size = static_cast<size_t>(levels[i].size);
+		if (header.compression == COMPRESSION_LZ4)
+		{
+			stored[i].resize(Lz4::GetMaxCompressedSize(size));
+			size_t compressedSize = Lz4::Compress(levelPixels[i], size, stored[i].data(), stored[i].size());
+			stored[i].resize(compressedSize > 0 && compressedSize < size ? compressedSize : 0);
+		}
+
+		offset = (offset + 15) & ~uint64_t(15);
+		levels[i].offset = offset;
+		levels[i].storedSize = stored[i].empty() ? size : stored[i].size();
+		offset += levels[i].storedSize;
+	}
+
+	std::error_code error;
+	std::string cachePath = GetCachePath(sourcePath);
+	fs::create_directories(fs::path(cachePath).parent_path(), error);
+
+	// written aside then renamed, readers never see a partial file
+	std::string temporaryPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	{
+		std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!output.is_open())
+		{
+			LogWarning("Can not write texture cache %s", cachePath.c_str());
+			return false;
+		}
+
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(levels.size() * sizeof(CacheLevel)));
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			static const char zeros[16] = {};
+			std::streamoff padding = static_cast<std::streamoff>(levels[i].offset) - output.tellp();
+			output.write(zeros, padding);
+
+			const unsigned char* data = stored[i].empty() ? levelPixels[i] : stored[i].data();
+			output.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(levels[i].storedSize));
+		}
+		if (!output.good())
+		{
+			output.close();
+			fs::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	fs::rename(temporaryPath, cachePath, error);
+	if (error)
+	{
+		fs::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+void TextureCache::SetEnabled(bool enabled)
+{
+	s_enabled = enabled;
+}
+
+bool TextureCache::IsEnabled()
+{
+	return s_enabled;
+}
+
+void TextureCache::SetCompression(bool compress)
+{
+	s_compress = compress;
+}
+
+std::string TextureCache::GetCachePath(const std::string& sourcePath)
+{
+	// FNV-1a of the normalized path keeps images with the same name apart
+	std::string key = fs::path(sourcePath).lexically_normal().generic_string();
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned char c : key)
+	{
+		hash = (hash ^ c) * 1099511628211ull;
+	}
+
+	char hashText[17];
+	snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(hash));
+	return CachePath::TEXTURE + fs::path(sourcePath).stem().string() + "_" + hashText + ".gstex";
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct MipLevel;
+
+/**
+ * @class TextureCache
+ * @brief Stores decoded textures on disk so later launches skip image decoding.
+ *
+ * Each source image gets a .gstex file in CachePath::TEXTURE holding its RGBA pixels and
+ * mip levels, raw or LZ4 compressed. The entry records the size and modification time of
+ * the source and is ignored once the source changes. Entries are read through a memory
+ * mapping, raw levels are handed to the caller without any copy.
+ */
+class TextureCache
+{
+public:
+	/**
+	 * @brief Called for each mip level read from the cache, largest first.
+	 * @param level The mip level.
+	 * @param width The width of the level.
+	 * @param height The height of the level.
+	 * @param pixels The RGBA pixels, only valid during the call.
+	 */
+	using LevelCallback = std::function<void(int level, int width, int height, const unsigned char* pixels)>;
+
+	/**
+	 * @brief Reads the cached levels of an image.
+	 * @param sourcePath The path to the source image.
+	 * @param onLevel Called for each level.
+	 * @param maxLevels Number of levels to read, 1 for the full size image only.
+	 * @return True if an up to date entry was found. Nothing is reported otherwise.
+	 */
+	static bool Read(const std::string& sourcePath, const LevelCallback& onLevel, int maxLevels = 32);
+
+	/**
+	 * @brief Writes the cache entry of an image, with its full mip chain built by MipChain.
+	 * @param sourcePath The path to the source image.
+	 * @param pixels The RGBA pixels of the decoded image.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @return True if the entry was written.
+	 *
+	 * Safe to call from job workers. The file is written under a temporary name and
+	 * renamed, so a reader never sees a partial entry.
+	 */
+	static bool Write(const std::string& sourcePath, const unsigned char* pixels, int width, int height);
+
+	/**
+	 * @brief Writes the cache entry of an image with a mip chain built by the caller.
+	 * @param sourcePath The path to the source image.
+	 * @param pixels The RGBA pixels of the decoded image.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @param mips The levels below the image, see MipChain::Build.
+	 * @return True if the entry was written.
+	 */
+	static bool Write(const std::string& sourcePath, const unsigned char* pixels, int width, int height, const std::vector<MipLevel>& mips);
+
+	/**
+	 * @brief Enables or disables the cache. Enabled by default.
+	 * @param enabled False to always decode the source images.
+	 */
+	static void SetEnabled(bool enabled);
+
+	/**
+	 * @brief Checks if the cache is enabled.
+	 * @return True if the cache is used.
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * @brief Sets whether new entries are LZ4 compressed. Enabled by default.
+	 * @param compress False to store raw pixels, bigger files but no decompression.
+	 */
+	static void SetCompression(bool compress);
+
+	/**
+	 * @brief Gets the cache file used for an image.
+	 * @param sourcePath The path to the source image.
+	 * @return The path to the .gstex file.
+	 */
+	static std::string GetCachePath(const std::string& sourcePath);
+};
\ No newline at end of file